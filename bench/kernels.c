@@ -0,0 +1,377 @@
+/** kernels.c  --  microbenchmarks of the double description kernels **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Usage:
+*    kernels [-d DIM] [-v VERTICES] [-f FACETS] [-p DENSITY] [-F FINAL]
+*            [-r ROUNDS] [-s SEED] [-k KERNEL[,KERNEL...]] [-H]
+*
+* A synthetic polytope is built with DIM+1 coordinates, the given
+* number of vertices and facets; each vertex-facet adjacency bit is set
+* with probability DENSITY, each vertex is final with probability
+* FINAL. The selected kernels are run ROUNDS times on the same data,
+* and one CSV line is printed for each kernel:
+*
+*   kernel,dim,vertices,facets,density,final,ops,ns_min,ns_avg,check
+*
+* where 'ops' is the number of kernel calls (vertices scanned for
+* get_next_vertex) in a round, 'ns_min' and
+* 'ns_avg' are the fastest and the average time of a single call in
+* nanoseconds, and 'check' is a checksum of the results; it must not
+* change when a kernel is rewritten. -H suppresses the header line.
+*
+* The kernels are static routines of poly.c, thus poly.c is included
+* here and not compiled separately. Compile from the MAXE/bench
+* directory as
+*    gcc -O3 -W -I../src -o kernels kernels.c ../src/params.c ../src/report.c \
+*         ../src/telemetry.c -lm
+* Use the same flags (such as -DBITMAP_32 or -DNO_ASM) as for maxe.
+*/
+
+#include "../src/poly.c"
+#include <time.h>	/* clock_gettime() */
+
+/***********************************************************************
+* Symbols of main.c and glp_oracle.c used by the included code
+*/
+volatile int dobreak=0, dodump=0;
+
+void get_oracle_stat(int *no, int *it, unsigned long *time, const char **ver)
+{   *no=0; *it=0; *time=0ul; *ver="no oracle"; }
+
+/***********************************************************************
+* Random numbers and timing
+*
+* unsigned long long xrandom(void)
+*    xorshift64* generator; the same seed gives the same data
+*
+* double xuniform(void)
+*    uniform random number in [0,1)
+*
+* double nanoclock(void)
+*    monotonic time in nanoseconds
+*/
+
+static unsigned long long xstate=88172645463325252ull;
+
+static unsigned long long xrandom(void)
+{   xstate ^= xstate>>12; xstate ^= xstate<<25; xstate ^= xstate>>27;
+    return xstate*2685821657736338717ull;
+}
+
+static double xuniform(void)
+{   return (double)(xrandom()>>11)*(1.0/9007199254740992.0); }
+
+static double nanoclock(void)
+{struct timespec ts;
+    if(clock_gettime(CLOCK_MONOTONIC,&ts)) return 0.0;
+    return 1e9*(double)ts.tv_sec+(double)ts.tv_nsec;
+}
+
+/***********************************************************************
+* Benchmark parameters and data
+*
+* int nVertices, nFacets, nRounds
+*    size of the synthetic polytope, number of rounds
+*
+* double Density, Final
+*    probability of an adjacency bit, and of a final vertex
+*
+* int PairNo, Pair[2*PairNo]
+*    random vertex pairs for vertex_intersection(), is_edge() and
+*    normalize_vertex(); at low density is_edge() rejects most of them
+*    as they have less than DIM-1 common facets
+*
+* int ScanPairNo, ScanPair[2*ScanPairNo]
+*    vertex pairs sharing at least DIM-1 facets, thus is_edge() does the
+*    full adjacency scan on them
+*
+* int ValueNo, double Value[ValueNo]
+*    values for round_to() and formatvalue(); half of them are close
+*    to rationals with small denominator
+*
+* int SystemNo, double *System
+*    linear systems of DIM equations for solve_lineq(), each has a
+*    unique solution
+*/
+
+static int nVertices=20000, nFacets=400, nRounds=10;
+static double Density=0.05, Final=0.5;
+
+#define PairNo		4096
+#define ValueNo		4096
+#define SystemNo	64
+#define ScanPairNo	1024
+
+static int Pair[2*PairNo], ScanPair[2*ScanPairNo];
+static double Value[ValueNo];
+static double *System;
+
+/* void build_polytope(void)
+*    allocate the DD structures and fill them with random data. Returns
+*    with exit(1) when out of memory. */
+static void build_polytope(void)
+{int vno,fno,i,j; double *x;
+    if(init_dd_structure(nVertices,nFacets)){ exit(1); }
+    NextVertex=nVertices; NextFacet=nFacets;
+    for(vno=0;vno<nVertices;vno++){
+        for(i=0;i<DIM;i++) VertexCoords(vno)[i]=xuniform();
+        VertexCoords(vno)[DIM]=1.0;
+        set_in_VertexLiving(vno);
+        if(xuniform()<Final) set_in_VertexFinal(vno);
+        for(fno=0;fno<nFacets;fno++) if(xuniform()<Density){
+            set_bit(VertexAdj(vno),fno); set_bit(FacetAdj(fno),vno);
+        }
+    }
+    for(fno=0;fno<nFacets;fno++){
+        for(i=0;i<DIM;i++) FacetCoords(fno)[i]=xuniform();
+        FacetCoords(fno)[DIM]=-0.5*DIM*xuniform();
+    }
+    request_main_loop_memory(0);
+    talloc(double,M_VertexDistStore,MaxVertices,1);
+    if(OUT_OF_MEMORY) exit(1);
+    for(i=0;i<2*PairNo;i++) Pair[i]=(int)(xrandom()%(unsigned long long)nVertices);
+    for(i=0;i<ValueNo;i++){
+        Value[i]= (i&1) ? 10.0*xuniform()-5.0 :
+            (double)((int)(xrandom()%200)-100)/(double)(1+xrandom()%12)
+            +1e-12*xuniform();
+    }
+    // each system has DIM equations a with a*x=0 for a random x
+    System=(double*)malloc(SystemNo*DIM*(DIM+1)*sizeof(double));
+    x=(double*)malloc((DIM+1)*sizeof(double));
+    if(!System || !x) exit(1);
+    for(j=0;j<SystemNo;j++){
+        for(i=0;i<DIM;i++) x[i]=(double)(1+xrandom()%16)/8.0;
+        for(vno=0;vno<DIM;vno++){
+            double *a=System+(j*DIM+vno)*(DIM+1); double s=0.0;
+            for(i=0;i<DIM;i++){ a[i]=2.0*xuniform()-1.0; s += a[i]*x[i]; }
+            a[DIM]=-s;
+        }
+    }
+    free(x);
+    // make the scan pairs share DIM-1 consecutive facets
+    for(i=0;i<ScanPairNo;i++){
+        int v1,v2;
+        v1=(int)(xrandom()%(unsigned long long)nVertices);
+        do v2=(int)(xrandom()%(unsigned long long)nVertices); while(v2==v1);
+        fno=(int)(xrandom()%(unsigned long long)nFacets);
+        for(j=0;j<DIM-1 && j<nFacets;j++,fno=(fno+1)%nFacets){
+            set_bit(VertexAdj(v1),fno); set_bit(FacetAdj(fno),v1);
+            set_bit(VertexAdj(v2),fno); set_bit(FacetAdj(fno),v2);
+        }
+        ScanPair[2*i]=v1; ScanPair[2*i+1]=v2;
+    }
+}
+
+/***********************************************************************
+* Kernels
+*
+* double kernel_xxx(int *ops)
+*    run a single round of the kernel, set the number of calls in
+*    'ops', and return the checksum.
+*/
+
+static double kernel_vertex_distance(int *ops)
+{int fno,vno; double s=0.0;
+    for(fno=0;fno<16;fno++) for(vno=0;vno<NextVertex;vno++)
+        s += vertex_distance(FacetCoords(fno),vno);
+    *ops=16*NextVertex;
+    return s;
+}
+
+static double kernel_vertex_intersection(int *ops)
+{int i; double s=0.0;
+    for(i=0;i<PairNo;i++) s += vertex_intersection(Pair[2*i],Pair[2*i+1]);
+    *ops=PairNo;
+    return s;
+}
+
+static double kernel_is_edge(int *ops)
+{int i; double s=0.0;
+    for(i=0;i<PairNo;i++) if(Pair[2*i]!=Pair[2*i+1])
+        s += is_edge(Pair[2*i],Pair[2*i+1],0);
+    *ops=PairNo;
+    return s;
+}
+
+static double kernel_is_edge_scan(int *ops)
+{int i; double s=0.0;
+    for(i=0;i<ScanPairNo;i++)
+        s += is_edge(ScanPair[2*i],ScanPair[2*i+1],0);
+    *ops=ScanPairNo;
+    return s;
+}
+
+static double kernel_normalize_vertex(int *ops)
+{int i; double s=0.0,d1; double *nv;
+    nv=NewVertexCoords(0,0);
+    for(i=0;i<PairNo;i++){
+        d1=(double)(1+(i&7))/16.0;
+        normalize_vertex(nv,d1,1.0-d1,
+            VertexCoords(Pair[2*i]),VertexCoords(Pair[2*i+1]));
+        s += nv[0];
+    }
+    *ops=PairNo;
+    return s;
+}
+
+static double kernel_solve_lineq(int *ops)
+{int j,i; double s=0.0; double *FA;
+    talloc(double,M_FacetArray,DIM,DIM+1);
+    FA=FacetArray(0);
+    for(j=0;j<SystemNo;j++){
+        memcpy(FA,System+j*DIM*(DIM+1),DIM*(DIM+1)*sizeof(double));
+        if(solve_lineq(DIM,DIM+1,FA)) continue;
+        for(i=0;i<=DIM;i++) s += FA[i];
+    }
+    *ops=SystemNo;
+    return s;
+}
+
+static double kernel_round_to(int *ops)
+{int i; double s=0.0,v;
+    for(i=0;i<ValueNo;i++){ v=Value[i]; round_to(&v); s += v; }
+    *ops=ValueNo;
+    return s;
+}
+
+static double kernel_formatvalue(int *ops)
+{int i; double s=0.0;
+    for(i=0;i<ValueNo;i++) s += (double)strlen(formatvalue(Value[i]));
+    *ops=ValueNo;
+    return s;
+}
+
+static double kernel_print_facet(int *ops)
+{int fno;
+    for(fno=0;fno<NextFacet;fno++) print_facet(R_savefacet,FacetCoords(fno));
+    *ops=NextFacet;
+    return (double)NextFacet;
+}
+
+static double kernel_get_next_vertex(int *ops)
+{int vno,n; double *to;
+    to=NewVertexCoords(0,0); n=0;
+    for(vno=get_next_vertex(0,to);vno>=0;vno=get_next_vertex(vno+1,to)) n++;
+    *ops=NextVertex; // vertices scanned
+    return (double)n;
+}
+
+static double kernel_reallocmem(int *ops)
+{   // grow the facet bitmap of all vertices by one block, then shrink it
+    yrequest(BITMAP_t,M_VertexAdjStore,MaxVertices,FacetBitmapBlockSize+DD_FACET_ADDBLOCK);
+    if(reallocmem()) exit(1);
+    yrequest(BITMAP_t,M_VertexAdjStore,MaxVertices,FacetBitmapBlockSize);
+    if(reallocmem()) exit(1);
+    *ops=2;
+    return (double)vertex_intersection(Pair[0],Pair[1]);
+}
+
+/***********************************************************************
+* Kernel table and main program
+*/
+
+typedef struct {
+    const char *name;		/* kernel name */
+    double (*run)(int *ops);	/* a single round */
+} kernel_t;
+
+static kernel_t Kernels[]={
+  {"vertex_distance",	 kernel_vertex_distance},
+  {"vertex_intersection",kernel_vertex_intersection},
+  {"is_edge",		 kernel_is_edge},
+  {"is_edge_scan",	 kernel_is_edge_scan},
+  {"normalize_vertex",	 kernel_normalize_vertex},
+  {"solve_lineq",	 kernel_solve_lineq},
+  {"round_to",		 kernel_round_to},
+  {"formatvalue",	 kernel_formatvalue},
+  {"print_facet",	 kernel_print_facet},
+  {"get_next_vertex",	 kernel_get_next_vertex},
+  {"reallocmem",	 kernel_reallocmem},
+  {NULL,NULL}
+};
+
+/* int selected(list,name)
+*    check if name is in the comma separated list; NULL list selects all */
+static int selected(const char *list, const char *name)
+{size_t l;
+    if(!list) return 1;
+    l=strlen(name);
+    while(*list){
+        if(strncmp(list,name,l)==0 && (list[l]==0 || list[l]==',')) return 1;
+        while(*list && *list!=',') list++;
+        if(*list) list++;
+    }
+    return 0;
+}
+
+static void run_kernel(kernel_t *k)
+{int r,ops; double start,t,tmin,tsum,check;
+    check=k->run(&ops); // warm up
+    tmin=0.0; tsum=0.0;
+    for(r=0;r<nRounds;r++){
+        start=nanoclock();
+        check=k->run(&ops);
+        t=nanoclock()-start;
+        if(r==0 || t<tmin) tmin=t;
+        tsum += t;
+    }
+    printf("%s,%d,%d,%d,%g,%g,%d,%.2f,%.2f,%.10g\n",k->name,DIM,nVertices,
+        nFacets,Density,Final,ops,tmin/ops,tsum/(nRounds*(double)ops),check);
+    fflush(stdout);
+}
+
+static void usage(void)
+{   printf("usage: kernels [-d DIM] [-v VERTICES] [-f FACETS] [-p DENSITY] [-F FINAL]\n"
+      "               [-r ROUNDS] [-s SEED] [-k KERNEL[,KERNEL...]] [-H]\n"
+      "kernels:");
+    {kernel_t *k; for(k=&Kernels[0];k->name;k++) printf(" %s",k->name); }
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{int i,header; const char *list; kernel_t *k;
+ static const char *defaults[]={"kernels","-o","/dev/null","synthetic.vlp",NULL};
+    // default values; print_facet() writes to /dev/null
+    if(process_parameters(4,defaults)) return 1;
+    PARAMS(ProblemObjects)=10; PARAMS(Threads)=1; PARAMS(MessageLevel)=1;
+    PARAMS(SaveFacets)=1;
+    list=NULL; header=1;
+    for(i=1;i<argc;i++){
+        if(strcmp(argv[i],"-H")==0){ header=0; continue; }
+        if(argv[i][0]!='-' || !argv[i][1] || argv[i][2] || i+1>=argc){ usage(); return 1; }
+        switch(argv[i][1]){
+          case 'd': PARAMS(ProblemObjects)=atoi(argv[i+1]); break;
+          case 'v': nVertices=atoi(argv[i+1]); break;
+          case 'f': nFacets=atoi(argv[i+1]); break;
+          case 'p': Density=atof(argv[i+1]); break;
+          case 'F': Final=atof(argv[i+1]); break;
+          case 'r': nRounds=atoi(argv[i+1]); break;
+          case 's': xstate=88172645463325252ull^(unsigned long long)atol(argv[i+1]); break;
+          case 'k': list=argv[i+1]; break;
+          default: usage(); return 1;
+        }
+        i++;
+    }
+    if(DIM<3 || DIM>MAXIMAL_ALLOWED_DIMENSION || nVertices<2 || nFacets<2 || nRounds<1){
+        usage(); return 1;
+    }
+    build_polytope();
+    if(header) printf("kernel,dim,vertices,facets,density,final,ops,ns_min,ns_avg,check\n");
+    for(k=&Kernels[0];k->name;k++) if(selected(list,k->name)) run_kernel(k);
+    close_savefiles();
+    return 0;
+}
+
+/* EOF */
+
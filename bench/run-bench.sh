@@ -0,0 +1,115 @@
+#!/bin/sh
+## run-bench.sh  --  run maxe over a corpus of vlp problems
+##
+## This code is part of MAXE, a helper program for maximum entropy method.
+## Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+## There is ABSOLUTELY NO WARRANTY, use at your own risk.
+##
+## Usage:
+##   run-bench.sh [-m MAXE] [-g VLPGEN] [-c CORPUS] [-t "1 2 4"]
+##                [-o RESULT] [-b BASELINE] [-x TOLERANCE]
+##
+## Every *.vlp file in the CORPUS directory (default: corpus) is solved
+## by MAXE (default: ../src/maxe) with each thread count given after -t.
+## When CORPUS does not exist, the standard corpus is generated by
+## VLPGEN (default: ./vlpgen). One CSV line is written to RESULT
+## (default: bench.csv) for each run:
+##
+##   problem,threads,status,wall,oracle,iterations,memory
+##
+## wall and oracle are seconds, iterations is the number of facets added,
+## memory is the peak memory of the DD structures in bytes. The table is
+## also printed. With -b the wall times are compared to a previous
+## RESULT file, and runs slower by more than TOLERANCE percent (default
+## 10) are listed; the exit status is 1 if there is any.
+
+MAXE=../src/maxe
+VLPGEN=./vlpgen
+CORPUS=corpus
+THREADS="1 2 4"
+RESULT=bench.csv
+BASELINE=
+TOLERANCE=10
+
+while getopts m:g:c:t:o:b:x:h opt; do
+  case $opt in
+    m) MAXE=$OPTARG ;;
+    g) VLPGEN=$OPTARG ;;
+    c) CORPUS=$OPTARG ;;
+    t) THREADS=$OPTARG ;;
+    o) RESULT=$OPTARG ;;
+    b) BASELINE=$OPTARG ;;
+    x) TOLERANCE=$OPTARG ;;
+    *) sed -n 's/^## \{0,1\}//p' "$0"; exit 1 ;;
+  esac
+done
+
+if [ ! -x "$MAXE" ]; then
+  echo "run-bench: cannot execute $MAXE" >&2; exit 1
+fi
+
+## the standard corpus: file name, family, options
+if [ ! -d "$CORPUS" ]; then
+  if [ ! -x "$VLPGEN" ]; then
+    echo "run-bench: no corpus $CORPUS and cannot execute $VLPGEN" >&2; exit 1
+  fi
+  mkdir -p "$CORPUS" || exit 1
+  while read name family opts; do
+    "$VLPGEN" $family $opts > "$CORPUS/$name.vlp" || exit 1
+  done <<EOF
+random-6   random  -d 6 -n 200 -s 1
+random-8   random  -d 8 -n 100 -s 2
+cyclic-6   cyclic  -d 6 -n 60
+cyclic-8   cyclic  -d 8 -n 40
+product-6  product -d 6 -n 5
+product-8  product -d 8 -n 4
+maxent-3   maxent  -n 3
+maxent-4   maxent  -n 4
+EOF
+fi
+
+## run a single problem, print the CSV line
+## seconds are computed from the statistics printed by maxe
+run_one() {
+  start=$(date +%s.%N)
+  out=$("$MAXE" -p0 -y- -m1 -o /dev/null --PrintParams=0 --Threads="$2" "$1" 2>&1)
+  ret=$?
+  end=$(date +%s.%N)
+  printf '%s\n' "$out" | awk -v name="$(basename "$1" .vlp)" -v th="$2" \
+      -v ret=$ret -v start="$start" -v end="$end" '
+    function secs(t,  n,a,s,i){ # h:mm:ss.xx to seconds
+      n=split(t,a,":"); s=0; for(i=1;i<=n;i++) s=60*s+a[i]; return s }
+    function bytes(m,  u){ # readable() to bytes
+      u=substr(m,length(m)); if(u ~ /[0-9]/) return m+0;
+      m=substr(m,1,length(m)-1)+0;
+      return u=="k" ? m*1e3 : u=="M" ? m*1e6 : u=="G" ? m*1e9 : m*1e12 }
+    /^Problem /                  { status=$2 }
+    /^ total oracle time/        { oracle=secs($4) }
+    /^ facets added/             { iter=$3 }
+    /^ memory allocated/         { mem=bytes($3) }
+    END { if(status=="") status="failed(" ret ")";
+          printf "%s,%s,%s,%.2f,%.2f,%d,%.0f\n",name,th,status,end-start,oracle,iter,mem }'
+}
+
+echo "problem,threads,status,wall,oracle,iterations,memory" > "$RESULT"
+for f in "$CORPUS"/*.vlp; do
+  [ -f "$f" ] || continue
+  for t in $THREADS; do
+    run_one "$f" "$t" >> "$RESULT"
+  done
+done
+
+if command -v column >/dev/null 2>&1; then
+  column -t -s, "$RESULT"
+else
+  cat "$RESULT"
+fi
+
+[ -n "$BASELINE" ] || exit 0
+## compare wall times to the baseline
+awk -F, -v tol="$TOLERANCE" '
+  FNR==1 { next }
+  NR==FNR { base[$1 "," $2]=$4; next }
+  ($1 "," $2) in base && base[$1 "," $2]>0.5 && $4>base[$1 "," $2]*(1+tol/100) {
+     printf "slower: %s threads=%s wall %.2f -> %.2f\n",$1,$2,base[$1 "," $2],$4; bad=1 }
+  END { exit bad }' "$BASELINE" "$RESULT"
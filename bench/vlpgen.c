@@ -0,0 +1,265 @@
+/** vlpgen.c  --  generate synthetic vlp problems for benchmarking **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Usage:
+*    vlpgen <family> [-d DIM] [-n N] [-s SEED]
+*
+* Write a vlp problem to the standard output. The same arguments always
+* give the same file. Families:
+*
+*   random   N random points on the unit sphere around (1,...,1) which
+*            are in the unit cube [0,1]^DIM
+*   cyclic   N points on the trigonometric moment curve
+*            1+(cos t,sin t,cos 2t,sin 2t,...); a cyclic polytope
+*   product  product of DIM/2 polygons with N vertices each on a
+*            quarter circle; highly degenerate, DIM must be even
+*   maxent   the entropies of the N singletons and N(N-1)/2 pairs of
+*            N random variables subject to the Shannon inequalities;
+*            DIM=N(N+1)/2 is ignored
+*
+* The problem is to minimize the objectives, thus the solution is the
+* convex hull of the points (or the entropy region) plus the non-
+* negative orthant. A non-negative slack column is added to each
+* objective for this purpose. The internal point in the 'x' lines is
+* an achievable point plus one in each coordinate.
+*
+* Compile from the MAXE/bench directory as
+*    gcc -O2 -W -o vlpgen vlpgen.c -lm
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/***********************************************************************
+* Random numbers
+*
+* unsigned long long xrandom(void)
+*    xorshift64* generator
+*
+* double xuniform(void)
+*    uniform random number in [0,1)
+*
+* double xgauss(void)
+*    standard normal random number (Box-Muller)
+*/
+
+static unsigned long long xstate=88172645463325252ull;
+
+static unsigned long long xrandom(void)
+{   xstate ^= xstate>>12; xstate ^= xstate<<25; xstate ^= xstate>>27;
+    return xstate*2685821657736338717ull;
+}
+
+static double xuniform(void)
+{   return (double)(xrandom()>>11)*(1.0/9007199254740992.0); }
+
+static double xgauss(void)
+{double u;
+    u=xuniform(); if(u<1e-300) u=1e-300;
+    return sqrt(-2.0*log(u))*cos(2.0*M_PI*xuniform());
+}
+
+/***********************************************************************
+* Point families
+*
+* int Dim, PointNo
+*    dimension and number of points
+*
+* double *Point
+*    Point[k*Dim+i] is coordinate i of point k
+*
+* void random_points(), cyclic_points(), product_points()
+*    fill Point[] according to the family
+*/
+
+static int Dim=6, PointNo=50;
+static double *Point;
+
+#define POINT(k,i)	Point[(k)*Dim+(i)]
+
+static void random_points(void)
+{int k,i; double r;
+    for(k=0;k<PointNo;k++){
+        r=0.0;
+        for(i=0;i<Dim;i++){ POINT(k,i)=xgauss(); r += POINT(k,i)*POINT(k,i); }
+        r=sqrt(r); if(r==0.0) r=1.0;
+        for(i=0;i<Dim;i++) POINT(k,i)=1.0-fabs(POINT(k,i))/r;
+    }
+}
+
+static void cyclic_points(void)
+{int k,i; double t;
+    for(k=0;k<PointNo;k++){
+        t=2.0*M_PI*(double)k/(double)PointNo;
+        for(i=0;i<Dim;i++)
+            POINT(k,i)=1.0+((i&1) ? sin((double)(i/2+1)*t) : cos((double)(i/2+1)*t));
+    }
+}
+
+static void product_points(void)
+{int k,i,m,j; double th;
+    m=PointNo; // vertices of a single polygon
+    for(PointNo=1,i=0;i<Dim/2;i++) PointNo *= m;
+    Point=(double*)realloc(Point,PointNo*Dim*sizeof(double));
+    if(!Point){ fprintf(stderr,"vlpgen: out of memory\n"); exit(1); }
+    for(k=0;k<PointNo;k++){
+        j=k;
+        for(i=0;i<Dim;i+=2){
+            th=0.5*M_PI*(double)(j%m)/(double)(m-1); j /= m;
+            POINT(k,i)=1.0-cos(th); POINT(k,i+1)=1.0-sin(th);
+        }
+    }
+}
+
+/* void print_points(family)
+*    print the vlp file: columns 1..PointNo are convex coefficients,
+*    columns PointNo+1..PointNo+Dim are the slacks. Row 1 makes the sum
+*    of the coefficients 1; maxe needs at least two rows, row 2 is free. */
+static void print_points(const char *family)
+{int k,i,cols; double c;
+    cols=PointNo+Dim;
+    printf("c %s family, %d points in dimension %d\n",family,PointNo,Dim);
+    printf("p vlp min 2 %d %d %d %d\n",cols,PointNo,Dim,PointNo*Dim+Dim);
+    printf("i 1 s 1\ni 2 f\n");
+    for(k=1;k<=cols;k++) printf("j %d l 0\n",k);
+    for(k=1;k<=PointNo;k++) printf("a 1 %d 1\n",k);
+    for(i=0;i<Dim;i++){
+        for(k=0;k<PointNo;k++) if(POINT(k,i)!=0.0)
+            printf("o %d %d %.17g\n",i+1,k+1,POINT(k,i));
+        printf("o %d %d 1\n",i+1,PointNo+i+1);
+    }
+    for(i=0;i<Dim;i++){ // the average plus one
+        c=0.0; for(k=0;k<PointNo;k++) c += POINT(k,i);
+        printf("x %d %.17g\n",i+1,1.0+c/(double)PointNo);
+    }
+    printf("e\n");
+}
+
+/***********************************************************************
+* MaxEnt family
+*
+* Columns 1..2^N-1 are the entropies of the non-empty subsets of the N
+* variables indexed by the subset bitmap; rows are the elemental Shannon
+* inequalities:
+*    h(N)-h(N-i) >= 0
+*    h(iK)+h(jK)-h(ijK)-h(K) >= 0    i<j, K subset of N-{i,j}
+* Objectives are the entropies of singletons and pairs; the internal
+* point comes from N independent bits, h(S)=|S|. The problem is
+* invariant under permuting the variables; the swap of the first two
+* variables and the cyclic shift are declared as 'c symmetry' lines.
+*/
+
+static int bitcount(int v)
+{int c=0; while(v){ c += v&1; v>>=1; } return c; }
+
+/* void print_symmetry(n,perm)
+*    print the permutation of the objectives induced by moving variable
+*    i to perm[i] */
+static void print_symmetry(int n, const int *perm)
+{int S,T,i,obj,img;
+    printf("c symmetry");
+    for(S=1;S<(1<<n);S++) if(bitcount(S)<=2){
+        for(T=0,i=0;i<n;i++) if(S&(1<<i)) T |= 1<<perm[i];
+        for(obj=0,img=1;img<=T;img++) if(bitcount(img)<=2) obj++;
+        printf(" %d",obj);
+    }
+    printf("\n");
+}
+
+static void print_maxent(int n)
+{int full,rows,cols,objs,row,i,j,K,obj,S; int perm[8];
+    full=(1<<n)-1;
+    objs=n+n*(n-1)/2;
+    cols=full+objs;
+    rows=n; // count the submodularity rows
+    for(i=0;i<n;i++) for(j=i+1;j<n;j++)
+        for(K=0;K<=full;K++) if(!(K&((1<<i)|(1<<j)))) rows++;
+    printf("c maxent family, %d random variables, %d objectives\n",n,objs);
+    printf("p vlp min %d %d %d %d %d\n",rows,cols,4*rows,objs,2*objs);
+    for(i=0;i<n;i++) perm[i]=i;
+    perm[0]=1; perm[1]=0; print_symmetry(n,perm);
+    if(n>2){ for(i=0;i<n;i++) perm[i]=(i+1)%n; print_symmetry(n,perm); }
+    for(row=1;row<=rows;row++) printf("i %d l 0\n",row);
+    for(S=1;S<=cols;S++) printf("j %d l 0\n",S);
+    row=0;
+    for(i=0;i<n;i++){
+        row++;
+        printf("a %d %d 1\n",row,full);
+        if(full-(1<<i)) printf("a %d %d -1\n",row,full-(1<<i));
+    }
+    for(i=0;i<n;i++) for(j=i+1;j<n;j++)
+      for(K=0;K<=full;K++) if(!(K&((1<<i)|(1<<j)))){
+        row++;
+        printf("a %d %d 1\n",row,K|(1<<i));
+        printf("a %d %d 1\n",row,K|(1<<j));
+        printf("a %d %d -1\n",row,K|(1<<i)|(1<<j));
+        if(K) printf("a %d %d -1\n",row,K);
+    }
+    obj=0;
+    for(S=1;S<=full;S++) if(bitcount(S)<=2){
+        obj++;
+        printf("o %d %d 1\n",obj,S);
+        printf("o %d %d 1\n",obj,full+obj);
+        printf("x %d %d\n",obj,1+bitcount(S));
+    }
+    printf("e\n");
+}
+
+/***********************************************************************
+* Main program
+*/
+
+static void usage(void)
+{   printf("usage: vlpgen {random|cyclic|product|maxent} [-d DIM] [-n N] [-s SEED]\n"
+      "write a synthetic vlp problem to stdout\n");
+}
+
+int main(int argc, char *argv[])
+{int i; const char *family;
+    if(argc<2 || argv[1][0]=='-'){ usage(); return 1; }
+    family=argv[1];
+    for(i=2;i<argc;i++){
+        if(argv[i][0]!='-' || !argv[i][1] || argv[i][2] || i+1>=argc){ usage(); return 1; }
+        switch(argv[i][1]){
+          case 'd': Dim=atoi(argv[i+1]); break;
+          case 'n': PointNo=atoi(argv[i+1]); break;
+          case 's': xstate=88172645463325252ull^(unsigned long long)atol(argv[i+1]); break;
+          default: usage(); return 1;
+        }
+        i++;
+    }
+    if(strcmp(family,"maxent")==0){
+        if(PointNo<2 || PointNo>8){
+            fprintf(stderr,"vlpgen: the number of variables must be between 2 and 8\n");
+            return 1;
+        }
+        print_maxent(PointNo); return 0;
+    }
+    if(Dim<2 || PointNo<2){ usage(); return 1; }
+    Point=(double*)malloc(PointNo*Dim*sizeof(double));
+    if(!Point){ fprintf(stderr,"vlpgen: out of memory\n"); return 1; }
+    if(strcmp(family,"random")==0) random_points();
+    else if(strcmp(family,"cyclic")==0) cyclic_points();
+    else if(strcmp(family,"product")==0){
+        if(Dim&1){ fprintf(stderr,"vlpgen: product needs even dimension\n"); return 1; }
+        product_points();
+    } else { usage(); return 1; }
+    print_points(family);
+    return 0;
+}
+
+/* EOF */
+
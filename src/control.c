@@ -0,0 +1,111 @@
+/** control.c  --  runtime control channel **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>	/* read(), close() */
+#include <fcntl.h>	/* open() */
+#include <sys/stat.h>	/* mkfifo(), stat() */
+#include "report.h"
+#include "params.h"
+#include "control.h"
+
+/***********************************************************************
+* Control data
+*
+* int ctl_fd, ctl_keep
+*    the pipe opened for reading; and for writing, so that reading
+*    does not report end of file when the writers are gone
+*
+* char ctl_buf[CTL_BUFSIZE], int ctl_len
+*    bytes read but not processed yet
+*
+* char ctl_cmd[CTL_BUFSIZE]
+*    the command returned by control_next()
+*
+* int ctl_skip
+*    set when the rest of an overlong line should be dropped
+*/
+
+#define CTL_BUFSIZE	256
+
+static int ctl_fd=-1, ctl_keep=-1;
+static char ctl_buf[CTL_BUFSIZE]; static int ctl_len=0;
+static char ctl_cmd[CTL_BUFSIZE];
+static int ctl_skip=0;
+
+int control_open(void)
+{struct stat st;
+    if(!PARAMS(ControlFile)) return 0;
+    if(stat(PARAMS(ControlFile),&st)==0){
+        if(!S_ISFIFO(st.st_mode)){
+            report(R_fatal,"control: %s exists and is not a named pipe\n",
+                PARAMS(ControlFile));
+            return 1;
+        }
+    } else if(mkfifo(PARAMS(ControlFile),0600)){
+        report(R_fatal,"control: cannot create named pipe %s (%s)\n",
+            PARAMS(ControlFile),strerror(errno));
+        return 1;
+    }
+    ctl_fd=open(PARAMS(ControlFile),O_RDONLY|O_NONBLOCK);
+    if(ctl_fd>=0) ctl_keep=open(PARAMS(ControlFile),O_WRONLY|O_NONBLOCK);
+    if(ctl_fd<0 || ctl_keep<0){
+        report(R_fatal,"control: cannot open named pipe %s\n",PARAMS(ControlFile));
+        control_close();
+        return 1;
+    }
+    ctl_len=0; ctl_skip=0;
+    return 0;
+}
+
+void control_close(void)
+{   if(ctl_fd>=0) close(ctl_fd);
+    if(ctl_keep>=0) close(ctl_keep);
+    ctl_fd=ctl_keep=-1; ctl_len=0;
+}
+
+/* int take_line(void)
+*    move the first complete line of ctl_buf[] to ctl_cmd[] without the
+*    surrounding spaces. Return 1 if a non-empty command was found. */
+static int take_line(void)
+{int i,j,k;
+    while(1){
+        for(i=0;i<ctl_len && ctl_buf[i]!='\n';i++);
+        if(i==ctl_len){ // no complete line
+            if(ctl_len==CTL_BUFSIZE){ ctl_len=0; ctl_skip=1; } // too long
+            return 0;
+        }
+        for(j=0;j<i && (ctl_buf[j]==' ' || ctl_buf[j]=='\t');j++);
+        for(k=i;k>j && (unsigned char)ctl_buf[k-1]<=' ';k--);
+        memcpy(ctl_cmd,ctl_buf+j,k-j); ctl_cmd[k-j]=0;
+        memmove(ctl_buf,ctl_buf+i+1,ctl_len-i-1); ctl_len-=i+1;
+        if(ctl_skip){ ctl_skip=0; continue; } // tail of an overlong line
+        if(ctl_cmd[0]) return 1;
+    }
+}
+
+const char *control_next(void)
+{ssize_t n;
+    if(ctl_fd<0) return NULL;
+    while(!take_line()){
+        n=read(ctl_fd,ctl_buf+ctl_len,CTL_BUFSIZE-ctl_len);
+        if(n<=0) return NULL; // nothing more, or error
+        ctl_len+=n;
+    }
+    return ctl_cmd;
+}
+
+/* EOF */
+
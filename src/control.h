@@ -0,0 +1,39 @@
+/** control.h  --  runtime control channel **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Control channel
+*
+* Commands for a running job are read from the named pipe given by the
+* option --control=<fifo>. The pipe is read without blocking; commands
+* are executed by the main loop between two iterations.
+*
+* int control_open(void)
+*    when PARAMS(ControlFile) is set, create the named pipe if it does
+*    not exist, and open it. Return non-zero on error; the error is
+*    reported.
+*
+* const char *control_next(void)
+*    return the next command, or NULL if there is none. Leading and
+*    trailing spaces are removed, empty lines are skipped.
+*
+* void control_close(void)
+*    close the pipe; it is not deleted.
+*/
+
+int control_open(void);
+const char *control_next(void);
+void control_close(void);
+
+/* EOF */
+
@@ -20,8 +20,9 @@
 /**********************************************************************
 * Read vertices and facets from a file
 *
-* int LINELEN = 512
-*   maximum length of a line
+* int LINELEN = 4096
+*   maximum length of a line; a Q or A line of dimension 100 written
+*   with full precision fits in it
 * char line[LINELEN]
 *   next line from the file
 * FILE *handle
@@ -29,17 +30,18 @@
 * char *filename
 *   the original file name to show in error messages
 */
-#define LINELEN		512
+#define LINELEN		4096
 static char *line=NULL;
 static FILE *handle=NULL; /* filehandle */
 static char *filename=NULL;
 
 /* int nextline(int *type)
-*   read the next line starting with 'V', 'v', 'F', 'N' into line[]. If
-*   there are no more lines, close the filehandle.
+*   read the next line starting with 'V', 'v', 'F', 'N', 'Q', 'A' into
+*   line[]. If there are no more lines, close the filehandle.
 *   Return values:
 *     1: next line is in line[]; *type is set to the type of the line:
-*          'V'=1, 'v'=2, 'F'=3, 'N'=4; other lines are ignored
+*          'V'=1, 'v'=2, 'F'=3, 'N'=4, 'Q'=5, 'A'=6; other lines are
+*          ignored
 *     0: EOF, filehandle is closed.
 */
 int nextline(int *type)
@@ -54,6 +56,8 @@ int nextline(int *type)
             else if(ch=='v'){ *type=2; sp=1; }
             else if(ch=='F'){ *type=3; sp=1; }
             else if(ch=='N'){ *type=4; sp=1; }
+            else if(ch=='Q'){ *type=5; sp=1; }
+            else if(ch=='A'){ *type=6; sp=1; }
             else {i=-1; } // all other lines are skipped
             continue;
         }
@@ -20,7 +20,7 @@
 * int nextline( int *type)
 *   read the next line into the internal buffer. Return values:
 *     1: next line read, *type contains the type of the line:
-*         1: V, 2: F, 3: f, 4: N
+*         1: V, 2: v, 3: F, 4: N, 5: Q, 6: A
 *     0: no more lines, file handle is closed
 *
 * int parseline(int num, double to[0..num-1])
@@ -0,0 +1,266 @@
+/** exchange.c  --  exchanging facets between processes **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>	/* time() */
+#include <unistd.h>	/* getpid(), gethostname() */
+#include <dirent.h>	/* opendir(), readdir() */
+#include "report.h"
+#include "params.h"
+#include "hashkey.h"
+#include "exchange.h"
+
+/***********************************************************************
+* Exchange data
+*
+* FILE *xfile, char *xname
+*    the file of this process, opened for appending, and its name
+*    within the directory
+*
+* uint64_t vlp_hash
+*    hash of the vlp file content and the settings which change the
+*    facets; it is written to the header line of the file
+*
+* time_t xlast
+*    time of the last exchange
+*
+* peer_t *peer, int peerno, peermax
+*    files of other processes found in the directory; the next read
+*    starts at 'offset'
+*
+* keyset_t seen
+*    hash set of 128 bit keys of the facets exported or imported, see
+*    hashkey.h
+*
+* double *queue, int qhead, qno, qmax
+*    imported facets, qhead is the next one to be handed out
+*
+* char *xline, int xlinemax
+*    buffer for reading a line
+*
+* int stat_exported, stat_imported, stat_duplicate
+*    statistics
+*/
+
+#define DIM		PARAMS(ProblemObjects)
+#define XCH_SUFFIX	".fct"
+
+typedef struct {
+    char *name;		/* file name within the directory */
+    long offset;	/* next read starts here */
+    int  state;		/* 0: header not read, 1: OK, -1: other problem */
+} peer_t;
+
+static FILE *xfile=NULL;
+static char *xname=NULL;
+static uint64_t vlp_hash=0;
+static time_t xlast=0;
+static peer_t *peer=NULL; static int peerno=0, peermax=0;
+static keyset_t seen={NULL,0,0};
+static double *queue=NULL; static int qhead=0, qno=0, qmax=0;
+static char *xline=NULL; static int xlinemax=0;
+static int stat_exported=0, stat_imported=0, stat_duplicate=0;
+
+void get_exchange_stat(int *exported, int *imported, int *duplicate, int *files)
+{   *exported=stat_exported; *imported=stat_imported;
+    *duplicate=stat_duplicate; *files=peerno;
+}
+
+/***********************************************************************
+* Opening the file of this process
+*/
+
+int exchange_init(void)
+{char host[64],*path; size_t len;
+    if(!PARAMS(ExchangeDir)) return 0;
+    if(hash_vlp(&vlp_hash)){
+        report(R_fatal,"exchange: cannot read %s\n",PARAMS(VlpFile));
+        return 1;
+    }
+    if(gethostname(host,sizeof(host))) strcpy(host,"localhost");
+    host[sizeof(host)-1]=0;
+    xname=malloc(strlen(host)+40);
+    xlinemax=(DIM+1)*32+80;
+    xline=malloc(xlinemax);
+    if(!xname || !xline){
+        report(R_fatal,"exchange: out of memory\n");
+        return 1;
+    }
+    sprintf(xname,"%s-%ld" XCH_SUFFIX,host,(long)getpid());
+    len=strlen(PARAMS(ExchangeDir))+strlen(xname)+2;
+    path=malloc(len);
+    if(!path){ report(R_fatal,"exchange: out of memory\n"); return 1; }
+    sprintf(path,"%s/%s",PARAMS(ExchangeDir),xname);
+    xfile=fopen(path,"w");
+    if(!xfile){
+        report(R_fatal,"exchange: cannot create file %s\n",path);
+        free(path); return 1;
+    }
+    free(path);
+    fprintf(xfile,"C MAXE exchange %016llx %d\n",(unsigned long long)vlp_hash,DIM);
+    fflush(xfile);
+    xlast=time(NULL);
+    return 0;
+}
+
+void exchange_close(void)
+{int i;
+    if(xfile){ fclose(xfile); xfile=NULL; }
+    for(i=0;i<peerno;i++) free(peer[i].name);
+    free(peer); peer=NULL; peerno=peermax=0;
+    keyset_free(&seen);
+    free(queue); queue=NULL; qhead=qno=qmax=0;
+    free(xline); xline=NULL; xlinemax=0;
+    free(xname); xname=NULL;
+    stat_exported=stat_imported=stat_duplicate=0;
+}
+
+/***********************************************************************
+* Exporting facets
+*/
+
+void exchange_new_facet(const double *facet)
+{int i; uint64_t key,check;
+    if(!xfile) return;
+    vector_key(facet,1,FNV_OFFSET,&key,&check);
+    if(keyset_add(&seen,key,check)==0) return; // exported or imported earlier
+    fputc('F',xfile);
+    for(i=0;i<=DIM;i++) fprintf(xfile," %.17g",facet[i]);
+    fputc('\n',xfile);
+    stat_exported++;
+}
+
+/***********************************************************************
+* Importing facets
+*
+* void import_line(peer_t *p)
+*    handle a complete line read from the file of p
+*
+* void read_peer(peer_t *p)
+*    read the complete lines of the file of p from its offset
+*
+* peer_t *find_peer(const char *name)
+*    return the entry of the named file; add it if it is new. Return
+*    NULL if out of memory.
+*
+* void exchange(void)
+*    flush the facets of this process and read the other files
+*/
+
+static void import_line(peer_t *p)
+{unsigned long long h; int dim,i,r; char *s,*end; double *f; uint64_t key,check;
+    if(p->state==0){ // header line
+        if(sscanf(xline,"C MAXE exchange %llx %d",&h,&dim)==2 &&
+           h==(unsigned long long)vlp_hash && dim==DIM){
+            p->state=1;
+        } else {
+            p->state=-1;
+            report(R_warn,"exchange: file %s belongs to another problem, ignored\n",p->name);
+        }
+        return;
+    }
+    if(xline[0]!='F') return; // comment
+    if(qno>=qmax){
+        if(qhead>0){ // reuse the space of the handed out facets
+            memmove(queue,queue+qhead*(DIM+1),(qno-qhead)*(DIM+1)*sizeof(double));
+            qno-=qhead; qhead=0;
+        }
+        if(qno>=qmax){
+            f=realloc(queue,(2*qmax+64)*(DIM+1)*sizeof(double));
+            if(!f){ report(R_warn,"exchange: out of memory, facet dropped\n"); return; }
+            queue=f; qmax=2*qmax+64;
+        }
+    }
+    f=queue+qno*(DIM+1);
+    for(s=xline+1,i=0;i<=DIM;i++,s=end){
+        f[i]=strtod(s,&end);
+        if(end==s) return; // malformed line
+    }
+    vector_key(f,1,FNV_OFFSET,&key,&check);
+    r=keyset_add(&seen,key,check);
+    if(r==0){ stat_duplicate++; return; }
+    if(r<0){ report(R_warn,"exchange: out of memory, facet dropped\n"); return; }
+    qno++; stat_imported++;
+}
+
+static void read_peer(peer_t *p)
+{char *path; FILE *f; size_t len;
+    len=strlen(PARAMS(ExchangeDir))+strlen(p->name)+2;
+    path=malloc(len);
+    if(!path) return;
+    sprintf(path,"%s/%s",PARAMS(ExchangeDir),p->name);
+    f=fopen(path,"r");
+    free(path);
+    if(!f) return;
+    if(p->offset==0 || fseek(f,p->offset,SEEK_SET)==0)
+      while(p->state>=0 && fgets(xline,xlinemax,f)){
+        len=strlen(xline);
+        if(len==0 || xline[len-1]!='\n') break; // incomplete line, read it later
+        p->offset=ftell(f);
+        import_line(p);
+    }
+    fclose(f);
+}
+
+static peer_t *find_peer(const char *name)
+{int i; peer_t *p;
+    for(i=0;i<peerno;i++) if(strcmp(peer[i].name,name)==0) return peer+i;
+    if(peerno>=peermax){
+        p=realloc(peer,(2*peermax+8)*sizeof(peer_t));
+        if(!p) return NULL;
+        peer=p; peermax=2*peermax+8;
+    }
+    p=peer+peerno;
+    p->name=malloc(strlen(name)+1);
+    if(!p->name) return NULL;
+    strcpy(p->name,name); p->offset=0; p->state=0;
+    peerno++;
+    return p;
+}
+
+static void exchange(void)
+{DIR *dir; struct dirent *de; size_t len; peer_t *p;
+    fflush(xfile);
+    dir=opendir(PARAMS(ExchangeDir));
+    if(!dir) return;
+    while((de=readdir(dir))!=NULL){
+        len=strlen(de->d_name);
+        if(len<=strlen(XCH_SUFFIX) || strcmp(de->d_name+len-strlen(XCH_SUFFIX),XCH_SUFFIX)
+           || strcmp(de->d_name,xname)==0) continue;
+        p=find_peer(de->d_name);
+        if(p && p->state>=0) read_peer(p);
+    }
+    closedir(dir);
+}
+
+int exchange_next_facet(double *facet)
+{time_t now;
+    if(!xfile) return 0;
+    if(qhead>=qno){
+        qhead=qno=0;
+        now=time(NULL);
+        if(now-xlast<PARAMS(ExchangeDelay)) return 0;
+        xlast=now;
+        exchange();
+        if(qhead>=qno) return 0;
+    }
+    memcpy(facet,queue+qhead*(DIM+1),(DIM+1)*sizeof(double));
+    qhead++;
+    return 1;
+}
+
+/* EOF */
+
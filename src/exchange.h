@@ -0,0 +1,54 @@
+/** exchange.h  --  exchanging facets between processes **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Facet exchange
+*
+* Several processes solving the same problem with different random
+* seeds share their facets through the directory given by the option
+* --exchange=<dir>. Each process appends the facets returned by its
+* oracle to its own file <host>-<pid>.fct in the directory, and reads
+* the files of the other processes. The first line of each file is a
+* comment with the hash of the vlp file; files of other problems are
+* ignored. Imported facets are handed out as boot facets; duplicates
+* are dropped.
+*
+* int exchange_init(void)
+*    when PARAMS(ExchangeDir) is set, create the file of this process.
+*    Return non-zero on error; the error is reported.
+*
+* void exchange_new_facet(const double facet[0:dim])
+*    the oracle returned this facet, export it at the next exchange
+*
+* int exchange_next_facet(double facet[0:dim])
+*    if PARAMS(ExchangeDelay) seconds passed since the last exchange,
+*    flush the exported facets and read the new facets of the other
+*    processes. Copy the next imported facet to facet[] and return 1;
+*    return 0 if there are no more.
+*
+* void exchange_close(void)
+*    flush and close the file, release memory, clear the statistics
+*
+* void get_exchange_stat(int *exported, int *imported, int *duplicate, int *files)
+*    facets written and read, imported facets dropped as duplicates,
+*    and the number of files of other processes.
+*/
+
+int exchange_init(void);
+void exchange_new_facet(const double *facet);
+int exchange_next_facet(double *facet);
+void exchange_close(void);
+void get_exchange_stat(int *exported, int *imported, int *duplicate, int *files);
+
+/* EOF */
+
@@ -105,13 +105,13 @@ static inline void perm_array(int len, int arr[/* 1:len */])
 }
 /*---------------------------------------------------------------------
 * Storage for the constraint matrix, the objectives and the shuffle
-*   arrays. The matrix and the shuffle arrays will be freed after
-*   loading the problem into 'P'.
+*   arrays. The matrix will be freed after loading the problem into
+*   'P'; the shuffle arrays are kept for apply_vlp_variant().
 *
 * double M(row,col)             temporary storage for the constraint
 *                               matrix; indices go from 1
-* int vlp_rowidx[1:rows+objs]   shuffling rows, temporary
-* int vlp_colidx[1:cols+1]      shuffling columns, temporary
+* int vlp_rowidx[1:rows+objs]   shuffling rows
+* int vlp_colidx[1:cols+1]      shuffling columns
 * int vlp_objidx[1:objs]        objective indices in rows
 * int lambdaidx                 lambda column index
 * double vlp_lambda[1:objs]     obj coeffs in the lambda column
@@ -133,8 +133,8 @@ static inline void perm_array(int len, int arr[/* 1:len */])
 */
 
 static double *vlp_M;		/* temporary storage for M */
-static int *vlp_rowidx;		/* temporary row permutation */
-static int *vlp_colidx;		/* temporary column permutation */
+static int *vlp_rowidx;		/* row permutation */
+static int *vlp_colidx;		/* column permutation */
 static int *vlp_objidx;		/* object indices */
 static double *vlp_lambda;	/* lambda column */
 static double *vlp_init;	/* internal point from x lines */
@@ -239,10 +239,62 @@ static int glp_type(char ctrl)
     return -1;
 }
 
+/* int vlp_bound_line(const char *fname, int rows, int cols, int objs)
+ *   handle the 'j', 'i' or 'x' line in inpline[] read from 'fname'.
+ *   Return 1 on error, which is reported. */
+static int vlp_bound_line(const char *fname, int rows, int cols, int objs)
+{int i,j,cnt; double p,b1,b2; char ctrl;
+    switch(inpline[0]){
+      case 'j':  // j <col> [ f || l <val> | u <val> | d <val1> <val2> | s <val> ]
+                 b1=b2=0.0;
+                 cnt=sscanf(inpline,"j %d %c %lg %lg",&j,&ctrl,&b1,&b2);
+                 if(cnt<2 || cols<j || j<1 || !vlp_type_ok(ctrl,cnt)){
+                    report(R_fatal,"read_vlp: wrong j line in %s\n   %s\n",
+                                fname,inpline); return 1;
+                 }
+                 if(cnt<4) b2=b1; // GLP_UP uses b2 as the value
+                 glp_set_col_bnds(P,vlp_colidx[j],glp_type(ctrl),b1,b2);
+                 return 0;
+      case 'i':  // i <row> [ f | l <val> | u <val> | d <val1> <val2> | s <val> ]
+                 b1=b2=0.0;
+                 cnt=sscanf(inpline,"i %d %c %lg %lg",&i,&ctrl,&b1,&b2);
+                 if(cnt<2 || rows<i || i<1 || !vlp_type_ok(ctrl,cnt)){
+                    report(R_fatal,"read_vlp: wrong i line in %s\n   %s\n",
+                                fname,inpline); return 1;
+                 }
+                 if(cnt<4) b2=b1; // GLP_UP uses b2 as the value
+                 glp_set_row_bnds(P,vlp_rowidx[i],glp_type(ctrl),b1,b2);
+                 return 0;
+      case 'x':  cnt=sscanf(inpline,"x %d %lg",&i,&p);
+                 if(cnt!=2 || objs<i||i<1){
+                    report(R_fatal,"read_vlp: wrong x line in %s\n   %s\n",
+                                 fname,inpline); return 1;
+                 }
+                 vlp_init[i]=p; // store it
+                 return 0;
+    }
+    return 1;
+}
+
+/* int set_internal_point(void)
+ *   check that vlp_init[] is all positive, and fix the objective rows
+ *   to vlp_init[]. Return 1 on error, which is reported. */
+static int set_internal_point(void)
+{int i;
+    for(i=1;i<=vobjs;i++){
+        if(vlp_init[i]<PARAMS(PolytopeEps)){
+           report(R_fatal,"read_vlp: initial value[%d]=%lg not positive\n",
+                           i,vlp_init[i]); return 1;
+        }
+    }
+    for(i=1;i<=vobjs;i++) glp_set_row_bnds(P,vlp_objidx[i],GLP_FX,vlp_init[i],vlp_init[i]);
+    return 0;
+}
+
 /* read a vlp problem from a file as an LP instance
  * set lambda >=0  */
 int load_vlp(void)
-{FILE *f; int rows,cols,objs; int i,j,cnt; double p,b1,b2; char ctrl;
+{FILE *f; int rows,cols,objs; int i,j,cnt; double p; int *ind;
  double dir=1.0;
     f=fopen(PARAMS(VlpFile),"r");
     if(!f){
@@ -285,28 +337,13 @@ int load_vlp(void)
                     report(R_fatal,"read_vlp: j line before p in %s\n  %s\n",
                                PARAMS(VlpFile),inpline); return  1;
                  }
-                 b1=b2=0.0;
-                 cnt=sscanf(inpline,"j %d %c %lg %lg",&j,&ctrl,&b1,&b2);
-                 if(cnt<2 || cols<j || j<1 || !vlp_type_ok(ctrl,cnt)){
-                    report(R_fatal,"read_vlp: wrong j line in %s\n   %s\n",
-                                PARAMS(VlpFile),inpline); return 1;
-                 }
-                 if(cnt<4) b2=b1; // GLP_UP uses b2 as the value
-                 glp_set_col_bnds(P,vlp_colidx[j],glp_type(ctrl),b1,b2);
+                 if(vlp_bound_line(PARAMS(VlpFile),rows,cols,objs)) return 1;
                  continue;
        case 'i': if(rows==0){
                     report(R_fatal,"read_vlp: i line before p in %s\n   %s\n",
                                 PARAMS(VlpFile),inpline); return 1;
                  }
-                 // i <row> [ f | l <val> | u <val> | d <val1> <val2> | s <val> ]
-                 b1=b2=0.0;
-                 cnt=sscanf(inpline,"i %d %c %lg %lg",&i,&ctrl,&b1,&b2);
-                 if(cnt<2 || rows<i || i<1 || !vlp_type_ok(ctrl,cnt)){
-                    report(R_fatal,"read_vlp: wrong i line in %s\n   %s\n",
-                                PARAMS(VlpFile),inpline); return 1;
-                 }
-                 if(cnt<4) b2=b1; // GLP_UP uses b2 as the value
-                 glp_set_row_bnds(P,vlp_rowidx[i],glp_type(ctrl),b1,b2);
+                 if(vlp_bound_line(PARAMS(VlpFile),rows,cols,objs)) return 1;
                  continue;
        case 'a': if(rows==0){
                     report(R_fatal,"read_vlp: a line before p in %s\n   %s\n",
@@ -334,12 +371,7 @@ int load_vlp(void)
                      report(R_fatal,"read_vlp: x line before p in %s\n   %s\n",
                                  PARAMS(VlpFile),inpline); return 1;
                  }
-                 cnt=sscanf(inpline,"x %d %lg",&i,&p);
-                 if(cnt!=2 || objs<i||i<1){
-                    report(R_fatal,"read_vlp: wrong x line in %s\n   %s\n",
-                                 PARAMS(VlpFile),inpline); return 1;
-                 }
-                 vlp_init[i]=p; // store it
+                 if(vlp_bound_line(PARAMS(VlpFile),rows,cols,objs)) return 1;
                  continue;
        default: report(R_fatal,"read_vlp: unknown line in %s\n  %s\n",
                            PARAMS(VlpFile),inpline); return 1;
@@ -349,27 +381,55 @@ int load_vlp(void)
        report(R_fatal,"read_vlp: no 'p' line in %s\n",PARAMS(VlpFile)); return 1; 
     }
     /* the vlp file has been read; set the glpk LP instance */
-    // check if vlp_init[] is all positive
-    for(i=1;i<=objs;i++){
-        if(vlp_init[i]<PARAMS(PolytopeEps)){
-           report(R_fatal,"read_vlp: initial value[%d]=%lg not positive\n",
-                           i,vlp_init[i]); return 1;
-        }
-    }
+    // check if vlp_init[] is all positive, set objective lines to =vlp_init[]
+    if(set_internal_point()) return 1;
     // upload constraints into P
-    for(i=0;i<=rows+objs;i++) vlp_rowidx[i]=i; // index file
+    if(xalloc(ind,int,rows+objs+1)){
+        report(R_fatal,"read_vlp: out of memory for %s\n",PARAMS(VlpFile));
+        return 1;
+    }
+    for(i=0;i<=rows+objs;i++) ind[i]=i; // index file
     for(j=1;j<=cols+1;j++){
-        if(j!=lambda_idx) glp_set_mat_col(P,j,rows+objs,vlp_rowidx,&M(1,j)-1);
+        if(j!=lambda_idx) glp_set_mat_col(P,j,rows+objs,ind,&M(1,j)-1);
     }
-    free(vlp_colidx); free(vlp_rowidx); free(vlp_M);
-    // set objective lines to =vlp_init[]
-    for(i=1;i<=objs;i++) glp_set_row_bnds(P,vlp_objidx[i],GLP_FX,vlp_init[i],vlp_init[i]);
+    free(ind); free(vlp_M); vlp_M=NULL;
     // LP objective: maximize lambda
     glp_set_obj_coef(P,lambda_idx,1.0);
     glp_set_obj_dir(P,GLP_MAX);
     return 0;
 }
 
+/**********************************************************************
+* int load_vlp_header(void)
+*   read only the 'p' line of the vlp file to get the problem size
+*   and the direction. glpk is not touched; used by the replay mode.
+*/
+int load_vlp_header(void)
+{FILE *f; int rows,cols,objs,cnt;
+    f=fopen(PARAMS(VlpFile),"r");
+    if(!f){
+        report(R_fatal,"Cannot open vlp file %s for reading\n",PARAMS(VlpFile));
+        return 1;
+    }
+    rows=cols=objs=0; cnt=0;
+    while(nextline(f)) if(inpline[0]=='p'){
+        PARAMS(Direction)=0;
+        cnt=sscanf(inpline,"p vlp min %d %d %*d %d %*d",&rows,&cols,&objs);
+        if(cnt==0){
+            PARAMS(Direction)=1;
+            cnt=sscanf(inpline,"p vlp max %d %d %*d %d %*d",&rows,&cols,&objs);
+        }
+        break;
+    }
+    fclose(f);
+    if(cnt!=3 || rows<=1 || cols<=1 || objs<1){
+        report(R_fatal,"read_vlp: missing or wrong p line in %s\n",PARAMS(VlpFile));
+        return 1;
+    }
+    vrows=rows; vcols=cols; vobjs=objs;
+    return 0;
+}
+
 /**********************************************************************
 * void set_oracle_parameters(void)
 *   Set the LP solver parameters from the configuration:
@@ -462,54 +522,139 @@ static char *glp_return_msg(int retval)
 */
 
 #include "round.h" /* round_to */
+#include "ocache.h" /* oracle answer cache */
+#include "lpengine.h" /* native LP engine */
+
+/* native and glpk facets agree if coefficients differ by less than this */
+#define LPE_AGREE_EPS	1e-6
 
 /* count the number and measure time of LP calls */
 static int oracle_calls=0;
 static unsigned long oracle_time=0ul;
+/* native engine: duals, the answer for comparison, and time spent */
+static double *lpe_dual=NULL, *lpe_facet=NULL;
+static double lpe_time=0.0;	/* in microseconds */
+/* OracleEngine=1: every LPE_SAMPLE_EVERY-th answer of the engine is
+   also asked from glpk, and after LPE_SAMPLES such questions the
+   engine is switched off if it was slower */
+#define LPE_SAMPLE_EVERY	32
+#define LPE_SAMPLES		16
+static int lpe_answered=0, lpe_samples=0, lpe_slow=0;
+static double lpe_sample_time=0.0, glpk_sample_time=0.0;
+
+/**********************************************************************
+* Latency and iteration histograms
+*
+* int OH_BINS
+*    number of log2 bins. Bin b counts values in [2^b,2^(b+1)), bin 0
+*    also counts smaller values; latencies are in microseconds.
+*
+* oracle_hist_t OracleHist[OH_MAX]
+*    histograms of the call latency and simplex iterations for each
+*    outcome, and the maximal values.
+*
+* double call_latency, int call_iterations, int call_retried
+*    set by call_glp(): the latency and iterations of the last call,
+*    and whether glp_simplex() had to be called again.
+*
+* double oracle_clock(void)
+*    monotonic time in microseconds
+*
+* void record_hist(int outcome, double latency, int iterations)
+*    add the values to the histograms of the outcome
+*/
+#define OH_BINS		48
+
+typedef struct {
+    int    calls;		/* number of calls */
+    int    thist[OH_BINS];	/* latency histogram */
+    int    ihist[OH_BINS];	/* iteration histogram */
+    double tmax;		/* maximal latency */
+    int    imax;		/* maximal iteration count */
+} oracle_hist_t;
+
+static oracle_hist_t OracleHist[OH_MAX];
+static double call_latency=0.0;
+static int call_iterations=0, call_retried=0;
+
+#include <time.h>
+static double oracle_clock(void)
+{struct timespec ts;
+    if(clock_gettime(CLOCK_MONOTONIC,&ts)) return 0.0;
+    return 1e6*(double)ts.tv_sec+1e-3*(double)ts.tv_nsec;
+}
+
+static inline int log2bin(double v)
+{int b=0;
+    while(v>=2.0 && b<OH_BINS-1){ v*=0.5; b++; }
+    return b;
+}
+
+static void record_hist(int outcome, double latency, int iterations)
+{oracle_hist_t *h;
+    h=&OracleHist[outcome];
+    h->calls++;
+    h->thist[log2bin(latency)]++;
+    h->ihist[log2bin((double)iterations)]++;
+    if(h->tmax<latency) h->tmax=latency;
+    if(h->imax<iterations) h->imax=iterations;
+}
 
 /* call the glpk simplex solver twice if necessary */
 #include <sys/time.h> 
 static int call_glp(int reset)
-{int ret; struct timeval tv; unsigned long starttime;
+{int ret,it; struct timeval tv; unsigned long starttime; double start,rst;
     oracle_calls++;
     if(gettimeofday(&tv,NULL)==0){
         starttime=tv.tv_sec*1000 + (tv.tv_usec+500u)/1000u;
     } else {starttime=0ul;}
+    start=oracle_clock(); it=glp_get_it_cnt(P); call_retried=0;
     if(reset){
+       rst=oracle_clock();
        if(PARAMS(OracleMessage)<2) glp_term_out(GLP_OFF);
        glp_sort_matrix(P);
        if(PARAMS(OracleScale)) glp_scale_prob(P,GLP_SF_AUTO);
        glp_adv_basis(P,0);  // make this optimization
        glp_term_out(GLP_ON); // enable messages form glpk
+       record_hist(OH_reset,oracle_clock()-rst,0);
     }
     ret=glp_simplex(P,&parm);
     if(ret==GLP_EBADB || ret==GLP_ESING){ // invalid base
+       rst=oracle_clock();
        if(PARAMS(OracleMessage)<2) glp_term_out(GLP_OFF);
        if(PARAMS(OracleScale)) glp_scale_prob(P,GLP_SF_AUTO);
        glp_adv_basis(P,0);
        glp_term_out(GLP_ON);
-       oracle_calls++;
+       record_hist(OH_reset,oracle_clock()-rst,0);
+       oracle_calls++; call_retried=1;
        ret=glp_simplex(P,&parm);
     }
     if(ret==GLP_EFAIL){ // give it a second chance
+        rst=oracle_clock();
         if(PARAMS(OracleMessage)<2) glp_term_out(GLP_OFF);
         glp_adv_basis(P,0);
         glp_term_out(GLP_ON);
-        oracle_calls++;
+        record_hist(OH_reset,oracle_clock()-rst,0);
+        oracle_calls++; call_retried=1;
         ret=glp_simplex(P,&parm);
     }
+    call_latency=oracle_clock()-start;
+    call_iterations=glp_get_it_cnt(P)-it;
     if(gettimeofday(&tv,NULL)==0)
         oracle_time += (tv.tv_sec*1000 + (tv.tv_usec+500u)/1000u)-starttime;
     return ret;
 }
 
-int initialize_oracle(void)
+/* int internal_point(int reset)
+*   check that vlp_init[] is an internal point; start from the actual
+*   basis when reset is not set. Initialize the native engine. */
+static int internal_point(int reset)
 {int ret;
-    set_oracle_parameters();
     // check if E is an internal point
     // the lambda column is all zero
+    glp_set_mat_col(P,lambda_idx,0,NULL,NULL);
     glp_set_obj_dir(P,GLP_MIN);
-    ret=call_glp(1);
+    ret=call_glp(reset);
     if(ret){
        report(R_fatal,"Internal point: the oracle says: %s\n",glp_return_msg(ret));
        return ORACLE_FAIL;
@@ -520,61 +665,159 @@ int initialize_oracle(void)
        return ret==GLP_NOFEAS ? ORACLE_EMPTY : ORACLE_FAIL;
     } // otherwise OK
     glp_set_obj_dir(P,GLP_MAX);
+    // the native engine starts from this basis
+    if(PARAMS(OracleEngine) && !lpe_init(P,lambda_idx,vlp_objidx,vobjs)){
+        if(!lpe_dual &&
+           (xalloc(lpe_dual,double,vobjs+1) || xalloc(lpe_facet,double,vobjs+1))){
+            lpe_release(); free(lpe_dual); lpe_dual=NULL;
+        }
+    } else if(PARAMS(OracleEngine)){
+        report(R_warn,"The native LP engine cannot be used, glpk is called\n");
+        free(lpe_dual); free(lpe_facet); lpe_dual=NULL; lpe_facet=NULL;
+    }
     return ORACLE_OK;
 }
 
-/* int ask_oracle() 
-*   ask oracle about vvertex[0:vobjs], return vfacet[0:vobjs] as the
-*   separating supporting hyperplane; 
-*   vvertex*vfacet<=0; vlp_init*vfacet>0
+int initialize_oracle(void)
+{   set_oracle_parameters();
+    return internal_point(1);
+}
+
+int reinitialize_oracle(void)
+{   return internal_point(0);
+}
+
+/**********************************************************************
+* Sweep variants
+*
+* int apply_vlp_variant(FILE *f, const char *fname)
+*   read the next variant from the open stream 'f'.
+*
+* int facet_support(double facet[0:vobjs])
+*   minimize the facet normal over the feasible solutions and set the
+*   constant term so that the facet supports the actual polytope. The
+*   lambda column is fixed to zero and the objective rows are made free
+*   meanwhile; the glpk basis is kept.
+*
+* int *vlp_rowind, double *vlp_rowval, double *vlp_cost
+*   work arrays of size vcols+2 for facet_support()
 */
-int ask_oracle(void)
-{int i,ret,ltype; double lambda,d;
-    if(vvertex[vobjs]==0.0){ // ideal point
-       for(i=1;i<=vobjs;i++){vlp_lambda[i]=0.0-vvertex[i-1]; }
-    } else { // not an ideal point
-       for(i=1;i<=vobjs;i++){vlp_lambda[i]=vlp_init[i]-vvertex[i-1]; }
+static int *vlp_rowind=NULL;
+static double *vlp_rowval=NULL, *vlp_cost=NULL;
+
+int apply_vlp_variant(FILE *f, const char *fname)
+{int lines=0;
+    while(nextline(f)){
+        if(inpline[0]=='c') continue;
+        lines++;
+        switch(inpline[0]){
+          case 'e': break;
+          case 'i': case 'j': case 'x':
+            if(vlp_bound_line(fname,vrows,vcols,vobjs)) return 1;
+            continue;
+          default:
+            report(R_fatal,"sweep: only i, j and x lines are allowed in %s\n   %s\n",
+                fname,inpline);
+            return 1;
+        }
+        break; // 'e' line
     }
-    ltype=glp_get_col_stat(P,lambda_idx); // GLP_BS
-// printf("ask_oracle(");for(i=1;i<=vobjs;i++){printf(" %lg",vvertex[i-1]);}printf(") type=%d\n",ltype);
-    glp_set_mat_col(P,lambda_idx,vobjs,vlp_objidx,vlp_lambda);
-    ret=call_glp(ltype!=GLP_BS);
-    if(ret){
-        report(R_fatal,"The oracle says: %s (%d)\n",glp_return_msg(ret),ret);
-        // one can continue if  ret==GLP_EITLIM || ret==GLP_ETMLIM
+    if(lines==0) return -1; // no more variants
+    return set_internal_point();
+}
+
+int facet_support(double *facet)
+{int i,j,len,ret,status; double d;
+    if(!vlp_cost && (xalloc(vlp_rowind,int,vcols+2) ||
+       xalloc(vlp_rowval,double,vcols+2) || xalloc(vlp_cost,double,vcols+2))){
+        report(R_fatal,"facet_support: out of memory\n");
         return ORACLE_FAIL;
     }
-    ret=glp_get_status(P);
-    if(ret == GLP_UNBND || ret==GLP_INFEAS){
-        if(vvertex[vobjs]==0.0){ return ORACLE_UNBND;} // inside
-        report(R_fatal,"The oracle says: problem unbounded\n");
+    // the objective is the facet normal times the objective rows
+    for(j=1;j<=vcols+1;j++) vlp_cost[j]=0.0;
+    for(i=1;i<=vobjs;i++) if(facet[i-1]!=0.0){
+        len=glp_get_mat_row(P,vlp_objidx[i],vlp_rowind,vlp_rowval);
+        for(j=1;j<=len;j++) vlp_cost[vlp_rowind[j]] += facet[i-1]*vlp_rowval[j];
+    }
+    vlp_cost[lambda_idx]=0.0;
+    for(j=1;j<=vcols+1;j++) glp_set_obj_coef(P,j,vlp_cost[j]);
+    glp_set_col_bnds(P,lambda_idx,GLP_FX,0.0,0.0);
+    for(i=1;i<=vobjs;i++) glp_set_row_bnds(P,vlp_objidx[i],GLP_FR,0.0,0.0);
+    glp_set_obj_dir(P,GLP_MIN);
+    ret=call_glp(0);
+    status=glp_get_status(P); d=glp_get_obj_val(P);
+    // restore the oracle LP
+    for(j=1;j<=vcols+1;j++) glp_set_obj_coef(P,j,j==lambda_idx ? 1.0 : 0.0);
+    glp_set_col_bnds(P,lambda_idx,GLP_LO,0.0,0.0);
+    for(i=1;i<=vobjs;i++) glp_set_row_bnds(P,vlp_objidx[i],GLP_FX,vlp_init[i],vlp_init[i]);
+    glp_set_obj_dir(P,GLP_MAX);
+    if(ret){
+        report(R_fatal,"Facet support: the oracle says: %s\n",glp_return_msg(ret));
         return ORACLE_FAIL;
     }
-    if(ret != GLP_OPT){
-        report(R_fatal,"The oracle says: %s (%d)\n",glp_status_msg(ret),ret);
-        return ORACLE_FAIL; 
+    if(status==GLP_UNBND) return ORACLE_UNBND;
+    if(status==GLP_NOFEAS) return ORACLE_EMPTY;
+    if(status!=GLP_OPT){
+        report(R_fatal,"Facet support: the oracle says: %s\n",glp_status_msg(status));
+        return ORACLE_FAIL;
     }
-    lambda=glp_get_obj_val(P); // optimal value of lambda
+    d=-d; if(PARAMS(RoundFacets)) round_to(&d);
+    facet[vobjs]=d;
+    // the internal point must be on the positive side
+    for(i=1;i<=vobjs;i++) d+=vlp_init[i]*facet[i-1];
+    return d<PARAMS(PolytopeEps) ? ORACLE_UNBND : ORACLE_OK;
+}
+
+/* int ask_oracle() 
+*   ask oracle about vvertex[0:vobjs], return vfacet[0:vobjs] as the
+*   separating supporting hyperplane; 
+*   vvertex*vfacet<=0; vlp_init*vfacet>0
+*
+* int separate_vertex()
+*   does the job for ask_oracle(), which records the latency and
+*   iterations according to the outcome. Answers found in the oracle
+*   cache are returned without calling glpk. Depending on OracleEngine
+*   the question is given to the native engine, to glpk, or to both.
+*
+* int facet_from_dual(double lambda, int quiet)
+*   vfacet[0:vobjs-1] contains the duals of the objective rows and
+*   lambda is the optimal value. Normalize and round the facet, and
+*   compute its constant term. Don't report problems when 'quiet' is
+*   set; the question is given to glpk in that case.
+*
+* int glpk_vertex()
+*   solve the LP by glpk
+*
+* int native_vertex()
+*   solve the LP by the native engine. Return -1 if glpk should be
+*   asked instead.
+*
+* int timed_vertex()
+*   the native engine has answered; ask glpk as well and compare the
+*   latencies. glpk starts from the basis of its last question, thus
+*   the comparison favours the engine. Return the glpk answer.
+*/
+static int facet_from_dual(double lambda, int quiet)
+{int i; double d;
     /* if lambda ==1 the vertex is inside the polytope
      * the boundary point: vlp_init[i]-lambda*vlp_lambda[i]
      * the facet equation is the dual solution */
     if(lambda<10.0*PARAMS(PolytopeEps)){
-      report(R_fatal,"Initial point is on the boundary\n");
+      if(!quiet) report(R_fatal,"Initial point is on the boundary\n");
       return ORACLE_FAIL;
     }
     if(vvertex[vobjs]!=0.0 && lambda > 1.0-PARAMS(PolytopeEps)){
         if(lambda>1.0+PARAMS(PolytopeEps)){
-           report(R_fatal,"Numerical problem, lambda=%lg > 1.0\n",lambda);
+           if(!quiet) report(R_fatal,"Numerical problem, lambda=%lg > 1.0\n",lambda);
            return ORACLE_FAIL;
         }
         return ORACLE_UNBND;
     }
-    for(i=1;i<=vobjs;i++) vfacet[i-1]=glp_get_row_dual(P,vlp_objidx[i]);
     // normalize the equation to sum up to 1.0
     d=0.0;
     for(i=0;i<vobjs;i++) d += vfacet[i]<0 ? -vfacet[i]:vfacet[i];
     if(d<PARAMS(PolytopeEps)){
-       report(R_fatal,"Numerical problem, facet all zero\n");
+       if(!quiet) report(R_fatal,"Numerical problem, facet all zero\n");
        return ORACLE_FAIL;
     }
     for(i=0;i<vobjs;i++) vfacet[i] /= d;
@@ -593,17 +836,150 @@ int ask_oracle(void)
     // check that vvertex is on the negative side, vlp_init is on the positive side
     d=0.0; for(i=0;i<=vobjs;i++) d+=vvertex[i]*vfacet[i];
     if(d>0.0){
-        report(R_fatal,"Numerical error: vertex is on the negative side (%lg)\n",d);
+        if(!quiet) report(R_fatal,"Numerical error: vertex is on the negative side (%lg)\n",d);
         return ORACLE_FAIL;
     }
     d=vfacet[vobjs]; for(i=1;i<=vobjs;i++) d+=vlp_init[i]*vfacet[i-1];
     if(d<PARAMS(PolytopeEps)){
-        report(R_fatal,"Initial point is on the negative side (%lg) of the next facet\n",d);
+        if(!quiet) report(R_fatal,"Initial point is on the negative side (%lg) of the next facet\n",d);
         return ORACLE_FAIL;
     }
     return ORACLE_OK;
 }
 
+static int glpk_vertex(void)
+{int i,ret,ltype;
+    ltype=glp_get_col_stat(P,lambda_idx); // GLP_BS
+    glp_set_mat_col(P,lambda_idx,vobjs,vlp_objidx,vlp_lambda);
+    ret=call_glp(ltype!=GLP_BS);
+    if(ret){
+        report(R_fatal,"The oracle says: %s (%d)\n",glp_return_msg(ret),ret);
+        // one can continue if  ret==GLP_EITLIM || ret==GLP_ETMLIM
+        return ORACLE_FAIL;
+    }
+    ret=glp_get_status(P);
+    if(ret == GLP_UNBND || ret==GLP_INFEAS){
+        if(vvertex[vobjs]==0.0){ return ORACLE_UNBND;} // inside
+        report(R_fatal,"The oracle says: problem unbounded\n");
+        return ORACLE_FAIL;
+    }
+    if(ret != GLP_OPT){
+        report(R_fatal,"The oracle says: %s (%d)\n",glp_status_msg(ret),ret);
+        return ORACLE_FAIL; 
+    }
+    for(i=1;i<=vobjs;i++) vfacet[i-1]=glp_get_row_dual(P,vlp_objidx[i]);
+    return facet_from_dual(glp_get_obj_val(P),0);
+}
+
+static int native_vertex(void)
+{int i,ret,calls,solved,pivots,mismatch; double lambda,start;
+    if(!lpe_dual || lpe_slow) return -1; // not initialized or too slow
+    get_lpe_stat(&calls,&solved,&pivots,&mismatch);
+    start=oracle_clock(); call_retried=0;
+    ret=lpe_solve(vlp_lambda,&lambda,lpe_dual);
+    call_latency=oracle_clock()-start; lpe_time += call_latency;
+    call_iterations=-pivots;
+    get_lpe_stat(&calls,&solved,&pivots,&mismatch);
+    call_iterations += pivots;
+    if(ret==LPE_UNBND) return vvertex[vobjs]==0.0 ? ORACLE_UNBND : -1;
+    if(ret!=LPE_OPT) return -1;
+    for(i=0;i<vobjs;i++) vfacet[i]=lpe_dual[i];
+    ret=facet_from_dual(lambda,1);
+    return ret==ORACLE_FAIL ? -1 : ret;
+}
+
+static int timed_vertex(void)
+{int ret; double native_latency;
+    native_latency=call_latency;
+    ret=glpk_vertex();
+    if(ret!=ORACLE_OK && ret!=ORACLE_UNBND) return ret;
+    lpe_samples++;
+    lpe_sample_time += native_latency; glpk_sample_time += call_latency;
+    if(lpe_samples==LPE_SAMPLES && lpe_sample_time>glpk_sample_time){
+        lpe_slow=1;
+        report(R_warn,"The native LP engine is slower than glpk (%.0f vs %.0f"
+          " microseconds), glpk is called\n",lpe_sample_time/LPE_SAMPLES,
+          glpk_sample_time/LPE_SAMPLES);
+    }
+    return ret;
+}
+
+static int separate_vertex(void)
+{int i,ret,nret;
+    if(vvertex[vobjs]==0.0){ // ideal point
+       for(i=1;i<=vobjs;i++){vlp_lambda[i]=0.0-vvertex[i-1]; }
+    } else { // not an ideal point
+       for(i=1;i<=vobjs;i++){vlp_lambda[i]=vlp_init[i]-vvertex[i-1]; }
+    }
+    if(!PARAMS(OracleEngine)) return glpk_vertex();
+    nret=native_vertex();
+    if(PARAMS(OracleEngine)==1){
+        if(nret<0) return glpk_vertex();
+        if(lpe_samples<LPE_SAMPLES && ++lpe_answered%LPE_SAMPLE_EVERY==0)
+            return timed_vertex();
+        return nret;
+    }
+    // OracleEngine==2: ask both, return the glpk answer
+    if(nret==ORACLE_OK) memcpy(lpe_facet,vfacet,(vobjs+1)*sizeof(double));
+    ret=glpk_vertex();
+    if(nret<0) return ret;
+    if(nret!=ret) lpe_mismatch();
+    else if(ret==ORACLE_OK){
+        for(i=0;i<=vobjs;i++) if(fabs(lpe_facet[i]-vfacet[i])>LPE_AGREE_EPS) break;
+        if(i<=vobjs) lpe_mismatch();
+    }
+    return ret;
+}
+
+/* void record_query(int ret)
+*   write the question and the answer to the R_query channel with
+*   full precision */
+static void record_query(int ret)
+{int i;
+    report(R_query,"Q");
+    for(i=0;i<=vobjs;i++) report(R_query," %.17g",vvertex[i]);
+    report(R_query,"\nA %d",ret);
+    for(i=0;i<=vobjs;i++) report(R_query," %.17g",ret==ORACLE_OK ? vfacet[i] : 0.0);
+    report(R_query,"\n");
+}
+
+int ask_oracle(void)
+{int ret;
+    ret=ocache_lookup(vvertex,vfacet);
+    if(ret<0){ // not in the cache
+        ret=separate_vertex();
+        if(ret==ORACLE_OK || ret==ORACLE_UNBND){
+            record_hist(call_retried ? OH_retry : ret==ORACLE_OK ? OH_facet : OH_final,
+               call_latency,call_iterations);
+            ocache_store(vvertex,ret,vfacet);
+        }
+    }
+    if(PARAMS(QueryFile)) record_query(ret);
+    return ret;
+}
+
+/**********************************************************************
+* void release_oracle(void)
+*   delete the glpk problem, free the oracle data and clear the
+*   statistics so that load_vlp() can be called again.
+*/
+
+void release_oracle(void)
+{   if(P){ glp_delete_prob(P); P=NULL; }
+    free(vfacet); free(vvertex); vfacet=NULL; vvertex=NULL;
+    free(vlp_objidx); free(vlp_lambda); free(vlp_init);
+    vlp_objidx=NULL; vlp_lambda=NULL; vlp_init=NULL;
+    free(vlp_rowidx); free(vlp_colidx); vlp_rowidx=NULL; vlp_colidx=NULL;
+    free(vlp_rowind); free(vlp_rowval); free(vlp_cost);
+    vlp_rowind=NULL; vlp_rowval=NULL; vlp_cost=NULL;
+    oracle_calls=0; oracle_time=0ul;
+    memset(OracleHist,0,sizeof(OracleHist));
+    lpe_release(); free(lpe_dual); free(lpe_facet);
+    lpe_dual=NULL; lpe_facet=NULL; lpe_time=0.0;
+    lpe_answered=lpe_samples=lpe_slow=0;
+    lpe_sample_time=glpk_sample_time=0.0;
+}
+
 /**********************************************************************
 * Get oracle statistics
 *
@@ -614,8 +990,8 @@ int ask_oracle(void)
 
 void get_oracle_stat(int *no, int *it, unsigned long *time, const char **ver)
 {static char verstr[81]; const char *from; char *to; int cnt;
-    *no=oracle_calls; *it=glp_get_it_cnt(P); 
-    *time=(oracle_time+5ul)/10ul; // in 0.01 seconds
+    *no=oracle_calls; *it= P ? glp_get_it_cnt(P) : 0;
+    *time=(oracle_time+(unsigned long)(lpe_time*1e-3)+5ul)/10ul; // in 0.01 seconds
     cnt=0; to=&verstr[0]; from="using glpk-";
     while(*from && cnt<80){ cnt++; *to=*from; to++; from++; }
     from=glp_version();
@@ -623,5 +999,32 @@ void get_oracle_stat(int *no, int *it, unsigned long *time, const char **ver)
     *to=0; *ver=&verstr[0];
 }
 
+int get_engine_stat(int *calls, int *solved, int *pivots, int *mismatch)
+{   get_lpe_stat(calls,solved,pivots,mismatch);
+    return lpe_dual!=NULL;
+}
+
+/* percentile from a log2 histogram; upper end of the bin, at most max */
+static double hist_percentile(const int hist[OH_BINS], int calls, double p, double max)
+{int b,cnt; double v;
+    cnt=0; v=1.0;
+    for(b=0;b<OH_BINS-1;b++){
+        v *= 2.0; cnt += hist[b];
+        if((double)cnt>=p*(double)calls) break;
+    }
+    return v<max ? v : max;
+}
+
+int get_oracle_hist(int outcome, double time[4], double iter[4])
+{oracle_hist_t *h; int i; static const double pct[3]={0.5,0.9,0.99};
+    h=&OracleHist[outcome];
+    for(i=0;i<3;i++){
+        time[i]=1e-6*hist_percentile(h->thist,h->calls,pct[i],h->tmax);
+        iter[i]=hist_percentile(h->ihist,h->calls,pct[i],(double)h->imax);
+    }
+    time[3]=1e-6*h->tmax; iter[3]=(double)h->imax;
+    return h->calls;
+}
+
 /* EOF */
 
@@ -22,7 +22,7 @@
 *
 * OracleData: struct containing the question to be asked from the
 *    oracle, and the answer it returns. The structure is allocated
-*    by load_vlp(), and never released.
+*    by load_vlp(), and released by release_oracle().
 *
 * int load_vlp(void)
 *  Read the polytope description from the vlp file; store problem 
@@ -32,6 +32,10 @@
 *    1: some error (syntax error, out of bound values, no memory);
 *      errors are reported as R_fatal. The vlp file might be left
 *      open. The program should abort, no way to recover.
+*
+* int load_vlp_header(void)
+*  Read only the problem size and direction from the vlp file without
+*    creating the glpk LP instance. Return value is the same.
 */
 
 
@@ -42,6 +46,7 @@ typedef struct {
 
 extern Oracle_t OracleData;
 int load_vlp(void);
+int load_vlp_header(void);
 
 /**********************************************************************
 * Oracle manipulation
@@ -67,6 +72,14 @@ int load_vlp(void);
 *    ORACLE_UNBND the vertex is inside or at the boundary
 *    ORACLE_FAIL  the LP solver failed to solve the problem
 *
+* int reinitialize_oracle()
+*  Check the internal point after apply_vlp_variant() starting from the
+*    actual basis. Return values are the same as for initialize_oracle().
+*
+* void release_oracle(void)
+*  Delete the LP instance and free OracleData; load_vlp() can read
+*    another problem afterwards.
+*
 * Errors are reported in R_fatal
 */
 #define ORACLE_OK	0
@@ -76,7 +89,34 @@ int load_vlp(void);
 #define ORACLE_FAIL	4	/* the oracle failed */
 
 int initialize_oracle(void);
+int reinitialize_oracle(void);
 int ask_oracle(void);
+void release_oracle(void);
+
+/**********************************************************************
+* Sweep variants
+*
+* int apply_vlp_variant(FILE *f, const char *fname)
+*  Read 'i', 'j' and 'x' lines from the open stream 'f' up to the next
+*    'e' line or EOF, and change the bounds and the internal point of
+*    the loaded LP in place; 'c' lines are skipped. Return value:
+*    0: variant applied, call reinitialize_oracle() next
+*    1: error, reported as R_fatal
+*   -1: no more variants in 'f'
+*
+* int facet_support(double facet[0:objs])
+*  Set the constant term of the facet so that it supports the polytope
+*    of the actual LP. Return value:
+*    ORACLE_OK     the facet has been moved, the internal point is on
+*                  its positive side
+*    ORACLE_UNBND  the normal is not bounded from below, or the internal
+*                  point is not on the positive side; drop the facet
+*    ORACLE_EMPTY  the LP has no feasible solution
+*    ORACLE_FAIL   the LP solver failed
+*/
+#include <stdio.h> /* FILE */
+int apply_vlp_variant(FILE *f, const char *fname);
+int facet_support(double *facet);
 
 /**********************************************************************
 * Get oracle statistics
@@ -87,5 +127,36 @@ int ask_oracle(void);
 */
 void get_oracle_stat(int *no, int *it, unsigned long *t, const char **ver);
 
+/**********************************************************************
+* int get_engine_stat(int *calls, int *solved, int *pivots, int *mismatch)
+*    return zero if the native LP engine is not used. Otherwise fill the
+*    number of questions it was asked and answered, the total number of
+*    pivots, and the answers differing from glpk when OracleEngine=2.
+*/
+int get_engine_stat(int *calls, int *solved, int *pivots, int *mismatch);
+
+/**********************************************************************
+* Oracle latency and iteration histograms
+*
+* OH_facet, OH_final, OH_retry, OH_reset
+*    outcome of an ask_oracle() call: separating facet found, the
+*    vertex is final, or glp_simplex() had to be called again after
+*    GLP_EBADB, GLP_ESING or GLP_EFAIL. OH_reset records the time of
+*    glp_scale_prob() and glp_adv_basis() resets.
+*
+* int get_oracle_hist(int outcome, double time[4], double iter[4])
+*    return the number of calls with the given outcome; fill the 50,
+*    90 and 99 percentiles and the maximum of the call latency (in
+*    seconds) and of the simplex iterations. Percentiles are read from
+*    log2 histograms, they are upper bounds within a factor of two.
+*/
+#define OH_facet	0	/* facet found */
+#define OH_final	1	/* the vertex is final */
+#define OH_retry	2	/* call was repeated */
+#define OH_reset	3	/* basis reset */
+#define OH_MAX		4
+
+int get_oracle_hist(int outcome, double time[4], double iter[4]);
+
 /* EOF */
 
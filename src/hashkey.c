@@ -0,0 +1,112 @@
+/** hashkey.c  --  hashing vectors and sets of hash keys **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>	/* llround() */
+#include "params.h"
+#include "hashkey.h"
+
+#define DIM		PARAMS(ProblemObjects)
+
+/***********************************************************************
+* Hash keys
+*/
+
+int hash_vlp(uint64_t *hash)
+{FILE *f; unsigned char buf[4096]; size_t n; int round; uint64_t h;
+    f=fopen(PARAMS(VlpFile),"r");
+    if(!f) return 1;
+    h=FNV_OFFSET;
+    while((n=fread(buf,1,sizeof(buf),f))>0) h=fnv_add(h,buf,n);
+    fclose(f);
+    round=PARAMS(RoundFacets);
+    *hash=fnv_add(h,&round,sizeof(round));
+    return 0;
+}
+
+void vector_key(const double *v, int facet, uint64_t seed,
+        uint64_t *key, uint64_t *check)
+{int i; double w; long long q; uint64_t h1,h2;
+    w=1.0;
+    if(facet || v[DIM]==0.0){ // facet or ideal vertex, normalize
+        w=0.0;
+        for(i=0;i<DIM;i++) w += v[i]<0.0 ? -v[i] : v[i];
+        if(w==0.0) w=1.0;
+    }
+    h1=seed; h2=seed^0x9e3779b97f4a7c15ull;
+    for(i=0;i<=DIM;i++){
+        q=llround(v[i]/(w*HASH_QUANTUM));
+        h1=fnv_add(h1,&q,sizeof(q));
+        h2=fnv_add(h2*FNV_PRIME,&q,sizeof(q));
+    }
+    if(h1==0) h1=1; // 0 marks empty slots
+    *key=h1; *check=h2;
+}
+
+/***********************************************************************
+* Key sets
+*
+* int keyset_grow(keyset_t *ks)
+*    double the number of slots, start with 1024. Return -1 if out of
+*    memory; the set is unchanged then.
+*/
+
+static int keyset_grow(keyset_t *ks)
+{size_t i,j,newsize; uint64_t *newslot;
+    newsize = ks->size ? 2*ks->size : 1024;
+    newslot=calloc(2*newsize,sizeof(uint64_t));
+    if(!newslot) return -1;
+    for(i=0;i<ks->size;i++) if(ks->slot[2*i]){
+        j=ks->slot[2*i]&(newsize-1);
+        while(newslot[2*j]) j=(j+1)&(newsize-1);
+        newslot[2*j]=ks->slot[2*i]; newslot[2*j+1]=ks->slot[2*i+1];
+    }
+    free(ks->slot); ks->slot=newslot; ks->size=newsize;
+    return 0;
+}
+
+int keyset_add(keyset_t *ks, uint64_t key, uint64_t check)
+{size_t j;
+    if(2*(ks->used+1)>ks->size && keyset_grow(ks)) return -1;
+    j=key&(ks->size-1);
+    while(ks->slot[2*j]){
+        if(ks->slot[2*j]==key && ks->slot[2*j+1]==check) return 0;
+        j=(j+1)&(ks->size-1);
+    }
+    ks->slot[2*j]=key; ks->slot[2*j+1]=check; ks->used++;
+    return 1;
+}
+
+int keyset_has(const keyset_t *ks, uint64_t key, uint64_t check)
+{size_t j;
+    if(ks->size==0) return 0;
+    j=key&(ks->size-1);
+    while(ks->slot[2*j]){
+        if(ks->slot[2*j]==key && ks->slot[2*j+1]==check) return 1;
+        j=(j+1)&(ks->size-1);
+    }
+    return 0;
+}
+
+void keyset_clear(keyset_t *ks)
+{   if(ks->used){ memset(ks->slot,0,2*ks->size*sizeof(uint64_t)); ks->used=0; }
+}
+
+void keyset_free(keyset_t *ks)
+{   free(ks->slot); ks->slot=NULL; ks->size=ks->used=0;
+}
+
+/* EOF */
@@ -0,0 +1,101 @@
+/** hashkey.h  --  hashing vectors and sets of hash keys **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#ifndef HASHKEY_H
+#define HASHKEY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/***********************************************************************
+* Hash keys
+*
+* The oracle cache, the facet exchange and the symmetry code identify
+* vertices and facets by a pair of 64 bit FNV-1a hashes of their
+* quantized coordinates. The first hash is the key, the second one is
+* a check value; the key is never zero.
+*
+* FNV_OFFSET, FNV_PRIME
+*    FNV-1a constants
+*
+* HASH_QUANTUM
+*    coordinates are rounded to a multiple of this value before hashing
+*
+* uint64_t fnv_add(uint64_t h, const void *data, size_t len)
+*    continue the FNV-1a hash h with the given bytes
+*
+* int hash_vlp(uint64_t *hash)
+*    hash the content of PARAMS(VlpFile) and the settings which change
+*    the facets. Return non-zero if the file cannot be read.
+*
+* void vector_key(const double v[0:dim], int facet, uint64_t seed,
+*        uint64_t *key, uint64_t *check)
+*    quantize the vector and compute its two hashes starting from seed.
+*    A facet is scaled so that the absolute values of its first dim
+*    coefficients add up to 1; a vertex is scaled that way only when
+*    it is ideal.
+*/
+
+#define FNV_OFFSET	0xcbf29ce484222325ull
+#define FNV_PRIME	0x100000001b3ull
+#define HASH_QUANTUM	1e-9
+
+static inline uint64_t fnv_add(uint64_t h, const void *data, size_t len)
+{const unsigned char *p=data;
+    while(len>0){ h ^= *p; h *= FNV_PRIME; p++; len--; }
+    return h;
+}
+
+int hash_vlp(uint64_t *hash);
+
+void vector_key(const double *v, int facet, uint64_t seed,
+        uint64_t *key, uint64_t *check);
+
+/***********************************************************************
+* Key sets
+*
+* keyset_t
+*    open addressing hash set of key and check pairs; {NULL,0,0} is
+*    an empty set
+*
+* int keyset_add(keyset_t *ks, uint64_t key, uint64_t check)
+*    add the key to the set. Return 1 if added, 0 if it was there,
+*    -1 if out of memory.
+*
+* int keyset_has(const keyset_t *ks, uint64_t key, uint64_t check)
+*    return 1 if the key is in the set
+*
+* void keyset_clear(keyset_t *ks)
+*    remove all keys, keep the space
+*
+* void keyset_free(keyset_t *ks)
+*    release the space; the set becomes empty
+*/
+
+typedef struct {
+    uint64_t *slot;	/* slot[2*i] is the key, 0 if empty, slot[2*i+1] the check */
+    size_t   size;	/* number of slots, a power of two */
+    size_t   used;	/* slots used */
+} keyset_t;
+
+int keyset_add(keyset_t *ks, uint64_t key, uint64_t check);
+
+int keyset_has(const keyset_t *ks, uint64_t key, uint64_t check);
+
+void keyset_clear(keyset_t *ks);
+
+void keyset_free(keyset_t *ks);
+
+#endif /* HASHKEY_H */
+
+/* EOF */
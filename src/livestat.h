@@ -0,0 +1,90 @@
+/** livestat.h  --  layout of the live statistics page **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Live statistics page
+*
+* When the option -os <file> is given, <file> is mapped into memory and
+* the running program updates the statistics below after each
+* iteration. Other programs, such as maxe-stat, can map the same file
+* and read the data without disturbing the computation. This header
+* is shared by maxe and maxe-stat; it must not depend on other headers.
+*
+* LIVESTAT_MAGIC, LIVESTAT_VERSION
+*    the first 8 bytes of the file, and the layout version. Increase
+*    the version when the layout changes; new fields go to the end.
+*
+* LIVESTAT_PHASES, LIVESTAT_NAMELEN
+*    maximal number of phases and the length of their names
+*
+* int seq
+*    sequence lock: odd while the page is being updated. A reader
+*    copies the page, and accepts the copy only if seq was even and
+*    has not changed during copying.
+*
+* int status
+*    -1 while running; the return value of outer() when finished:
+*    0: done, 4: error, 5-7: interrupted or limit exceeded
+*/
+
+#ifndef LIVESTAT_H
+#define LIVESTAT_H
+
+#include <stdint.h>
+
+#define LIVESTAT_MAGIC		"MAXESTAT"
+#define LIVESTAT_VERSION	1
+#define LIVESTAT_PHASES		16
+#define LIVESTAT_NAMELEN	12
+
+typedef struct {
+    char     magic[8];		/* LIVESTAT_MAGIC, not 0 terminated */
+    uint32_t version;		/* LIVESTAT_VERSION */
+    uint32_t size;		/* sizeof(livestat_t) */
+    volatile uint32_t seq;	/* sequence lock, odd when updating */
+    int32_t  pid;		/* process id of the writer */
+    int32_t  status;		/* -1: running, otherwise the exit status */
+    int32_t  threads;		/* number of threads */
+    double   start_time;	/* start time, seconds since the epoch */
+    double   update_time;	/* last update, seconds since the epoch */
+    double   elapsed;		/* seconds since start */
+    char     name[64];		/* problem name, 0 terminated */
+    int32_t  rows, cols, objs;	/* problem size */
+  /* DD_STATS */
+    int32_t  iterations;	/* facets added */
+    int32_t  facetno;		/* facets of the approximation */
+    int32_t  vertex_pos;	/* last number of positive vertices */
+    int32_t  vertex_neg;	/* last number of negative vertices */
+    int32_t  vertex_zero;	/* last number of vertices on the facet */
+    int32_t  vertex_new;	/* vertices added in total */
+    int32_t  max_vertices;	/* maximal number of vertices */
+    int32_t  instability_warning; /* numerical warnings */
+    double   avg_tests;		/* average edge tests in an iteration */
+    double   max_tests;		/* maximal edge tests in an iteration */
+    int64_t  total_memory;	/* memory allocated in bytes */
+    int64_t  max_memory;	/* maximal memory allocated */
+    int32_t  pool;		/* facets in the facet pool */
+  /* oracle */
+    int32_t  oracle_calls;	/* LP instances solved */
+    int64_t  oracle_rounds;	/* simplex iterations */
+    double   oracle_time;	/* seconds spent in glpk */
+  /* phases */
+    int32_t  phases;		/* number of phases used */
+    char     phase_name[LIVESTAT_PHASES][LIVESTAT_NAMELEN];
+    double   phase_time[LIVESTAT_PHASES]; /* summed over all threads */
+} livestat_t;
+
+#endif /* LIVESTAT_H */
+
+/* EOF */
+
@@ -0,0 +1,407 @@
+/** lpengine.c  --  native ray shooting LP engine **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "glpk.h"
+#include "lpengine.h"
+
+/***********************************************************************
+* The LP
+*
+* The LP of glpk has m rows and n columns. Variables 0..n-1 are the
+* columns, variables n..n+m-1 are the rows (auxiliary variables), and
+* the equations are A*x - r = 0. The objective is to maximize the
+* lambda variable.
+*
+* LPE_MAXROWS
+*    the basis is stored as a dense matrix, and a pivot costs O(m^2);
+*    larger problems are left to glpk
+*
+* LPE_ETAMAX
+*    after that many eta columns the basis is factorized again
+*
+* LPE_DEGENMAX
+*    after that many degenerate pivots in a row Bland's rule is used
+*    until a pivot makes progress, so the simplex cannot cycle
+*
+* LPE_PIVTOL, LPE_FEASTOL, LPE_DUALTOL
+*    pivot, primal and dual feasibility tolerances
+*
+* int m, n, lambda_var
+*    number of rows, columns, and the index of the lambda variable
+*
+* int *colstart, *rowidx; double *colval
+*    the columns of A in compressed form; the lambda column is stored
+*    separately in lambda_col[0:m-1]
+*
+* double *lb, *ub
+*    bounds of the variables, -HUGE_VAL or HUGE_VAL if missing
+*
+* int *obj_row
+*    obj_row[t] is the row index (0 based) of objective t
+*/
+
+#define LPE_MAXROWS	300
+#define LPE_ETAMAX	64
+#define LPE_DEGENMAX	20
+#define LPE_PIVTOL	1e-9
+#define LPE_FEASTOL	1e-9
+#define LPE_DUALTOL	1e-9
+
+static int m=0, n=0, objs=0, lambda_var=-1, ready=0;
+static int *colstart=NULL, *rowidx=NULL; static double *colval=NULL;
+static double *lambda_col=NULL;
+static double *lb=NULL, *ub=NULL;
+static int *obj_row=NULL;
+
+/***********************************************************************
+* Basis and factorization
+*
+* lu_t base, work
+*    dense LU factors with row permutation: B[perm[i],*] = (L*U)[i,*].
+*    'base' is the basis at the internal point, 'work' is used when a
+*    question needs more than LPE_ETAMAX pivots.
+*
+* int *head, *base_head
+*    head[i] is the basic variable of row i of the basis
+*
+* char *stat, *base_stat
+*    stat[k] is 0 for basic, 1 at lower bound, 2 at upper bound, 3 free
+*    at zero
+*
+* double *x, *base_x
+*    values of all variables
+*
+* double *eta, int *eta_row, int etano; lu_t *cur
+*    eta columns on top of the factors in *cur
+*
+* double *vec, *vec2
+*    work vectors of size m
+*/
+
+typedef struct {
+    double *a;		/* L below the diagonal, U above and on it */
+    int    *perm;	/* row permutation */
+} lu_t;
+
+static lu_t base={NULL,NULL}, work={NULL,NULL}, *cur=NULL;
+static int *head=NULL, *base_head=NULL;
+static char *stat=NULL, *base_stat=NULL;
+static double *x=NULL, *base_x=NULL;
+static double *eta=NULL; static int *eta_row=NULL; static int etano=0;
+static double *vec=NULL, *vec2=NULL;
+static int lpe_calls=0, lpe_solved=0, lpe_pivots=0, lpe_mismatches=0;
+
+void get_lpe_stat(int *calls, int *solved, int *pivots, int *mismatch)
+{   *calls=lpe_calls; *solved=lpe_solved; *pivots=lpe_pivots;
+    *mismatch=lpe_mismatches;
+}
+
+void lpe_mismatch(void){ lpe_mismatches++; }
+
+#define LU(f,i,j)	(f)->a[(size_t)(i)*m+(j)]
+
+/* void column(int k, double v[0:m-1])
+*    the dense column of variable k */
+static void column(int k, double *v)
+{int p;
+    memset(v,0,m*sizeof(double));
+    if(k==lambda_var){ memcpy(v,lambda_col,m*sizeof(double)); return; }
+    if(k>=n){ v[k-n]=-1.0; return; }
+    for(p=colstart[k];p<colstart[k+1];p++) v[rowidx[p]]=colval[p];
+}
+
+/* double dot_column(int k, const double y[0:m-1])
+*    y times the column of variable k */
+static double dot_column(int k, const double *y)
+{int p; double d;
+    if(k==lambda_var){
+        for(d=0.0,p=0;p<m;p++) d += y[p]*lambda_col[p];
+        return d;
+    }
+    if(k>=n) return -y[k-n];
+    for(d=0.0,p=colstart[k];p<colstart[k+1];p++) d += y[rowidx[p]]*colval[p];
+    return d;
+}
+
+/* int factorize(lu_t *f, const int head[0:m-1])
+*    LU factors of the basis with partial pivoting. Return non-zero
+*    if the basis is singular. */
+static int factorize(lu_t *f, const int *hd)
+{int i,j,k,piv; double w,maxw,*row,*prow;
+    for(j=0;j<m;j++){
+        column(hd[j],vec);
+        for(i=0;i<m;i++) LU(f,i,j)=vec[i];
+    }
+    for(i=0;i<m;i++) f->perm[i]=i;
+    for(k=0;k<m;k++){
+        piv=k; maxw=fabs(LU(f,k,k));
+        for(i=k+1;i<m;i++) if(fabs(LU(f,i,k))>maxw){ maxw=fabs(LU(f,i,k)); piv=i; }
+        if(maxw<LPE_PIVTOL) return 1; // singular
+        if(piv!=k){
+            row=&LU(f,k,0); prow=&LU(f,piv,0);
+            for(j=0;j<m;j++){ w=row[j]; row[j]=prow[j]; prow[j]=w; }
+            i=f->perm[k]; f->perm[k]=f->perm[piv]; f->perm[piv]=i;
+        }
+        for(i=k+1;i<m;i++) if(LU(f,i,k)!=0.0){
+            w = LU(f,i,k) /= LU(f,k,k);
+            for(j=k+1;j<m;j++) LU(f,i,j) -= w*LU(f,k,j);
+        }
+    }
+    return 0;
+}
+
+/* void ftran(double b[0:m-1])
+*    overwrite b by the solution of B*x=b */
+static void ftran(double *b)
+{int i,j,t,p; double w,*e;
+    for(i=0;i<m;i++) vec2[i]=b[cur->perm[i]];
+    for(i=0;i<m;i++){ // L, unit diagonal
+        for(w=vec2[i],j=0;j<i;j++) w -= LU(cur,i,j)*vec2[j];
+        vec2[i]=w;
+    }
+    for(i=m-1;i>=0;i--){ // U
+        for(w=vec2[i],j=i+1;j<m;j++) w -= LU(cur,i,j)*vec2[j];
+        vec2[i]=w/LU(cur,i,i);
+    }
+    memcpy(b,vec2,m*sizeof(double));
+    for(t=0;t<etano;t++){
+        e=eta+(size_t)t*m; p=eta_row[t];
+        w = b[p] /= e[p];
+        if(w!=0.0) for(i=0;i<m;i++) if(i!=p) b[i] -= e[i]*w;
+    }
+}
+
+/* void btran(double c[0:m-1])
+*    overwrite c by the solution of y*B=c */
+static void btran(double *c)
+{int i,j,t,p; double w,*e;
+    for(t=etano-1;t>=0;t--){
+        e=eta+(size_t)t*m; p=eta_row[t];
+        for(w=c[p],i=0;i<m;i++) if(i!=p) w -= c[i]*e[i];
+        c[p]=w/e[p];
+    }
+    for(j=0;j<m;j++){ // U transposed
+        for(w=c[j],i=0;i<j;i++) w -= LU(cur,i,j)*vec2[i];
+        vec2[j]=w/LU(cur,j,j);
+    }
+    for(j=m-1;j>=0;j--){ // L transposed
+        for(w=vec2[j],i=j+1;i<m;i++) w -= LU(cur,i,j)*vec2[i];
+        vec2[j]=w;
+    }
+    for(i=0;i<m;i++) c[cur->perm[i]]=vec2[i];
+}
+
+/* void basic_values(void)
+*    compute the basic variables from the non-basic ones */
+static void basic_values(void)
+{int k,i,p;
+    memset(vec,0,m*sizeof(double));
+    for(k=0;k<n+m;k++) if(stat[k] && x[k]!=0.0){
+        if(k==lambda_var){ for(i=0;i<m;i++) vec[i] -= lambda_col[i]*x[k]; }
+        else if(k>=n) vec[k-n] += x[k];
+        else for(p=colstart[k];p<colstart[k+1];p++) vec[rowidx[p]] -= colval[p]*x[k];
+    }
+    ftran(vec);
+    for(i=0;i<m;i++) x[head[i]]=vec[i];
+}
+
+/***********************************************************************
+* Initialization
+*/
+
+/* void lpe_free(void)
+*    free memory, keep the statistics */
+static void lpe_free(void)
+{   free(colstart); free(rowidx); free(colval); free(lambda_col);
+    free(lb); free(ub); free(obj_row);
+    free(base.a); free(base.perm); free(work.a); free(work.perm);
+    free(head); free(base_head); free(stat); free(base_stat);
+    free(x); free(base_x); free(eta); free(eta_row); free(vec); free(vec2);
+    colstart=rowidx=NULL; colval=lambda_col=lb=ub=NULL; obj_row=NULL;
+    base.a=work.a=NULL; base.perm=work.perm=NULL; cur=NULL;
+    head=base_head=NULL; stat=base_stat=NULL; x=base_x=NULL;
+    eta=NULL; eta_row=NULL; vec=vec2=NULL;
+    m=n=objs=0; lambda_var=-1; ready=0; etano=0;
+}
+
+void lpe_release(void)
+{   lpe_free();
+    lpe_calls=lpe_solved=lpe_pivots=lpe_mismatches=0;
+}
+
+/* void get_bounds(int type, double l, double u, double *lo, double *up)
+*    glpk bound type to lower and upper bounds */
+static void get_bounds(int type, double l, double u, double *lo, double *up)
+{   *lo=-HUGE_VAL; *up=HUGE_VAL;
+    switch(type){
+      case GLP_LO: *lo=l; break;
+      case GLP_UP: *up=u; break;
+      case GLP_DB: *lo=l; *up=u; break;
+      case GLP_FX: *lo=*up=l; break;
+      default: break; // GLP_FR
+    }
+}
+
+int lpe_init(glp_prob *P, int lambda_idx, const int *objidx, int nobjs)
+{int i,j,k,len,nnz,basic,st; int *ind; double *val;
+    lpe_free();
+    m=glp_get_num_rows(P); n=glp_get_num_cols(P);
+    if(m<1 || m>LPE_MAXROWS) return 1;
+    lambda_var=lambda_idx-1;
+    objs=nobjs; if(objs<1 || objs>m) return 1;
+    for(nnz=0,j=1;j<=n;j++) nnz += glp_get_mat_col(P,j,NULL,NULL);
+    ind=malloc((m+1)*sizeof(int)); val=malloc((m+1)*sizeof(double));
+    colstart=malloc((n+1)*sizeof(int));
+    rowidx=malloc((nnz+1)*sizeof(int)); colval=malloc((nnz+1)*sizeof(double));
+    lambda_col=calloc(m,sizeof(double));
+    lb=malloc((n+m)*sizeof(double)); ub=malloc((n+m)*sizeof(double));
+    obj_row=malloc(objs*sizeof(int));
+    base.a=malloc((size_t)m*m*sizeof(double)); base.perm=malloc(m*sizeof(int));
+    work.a=malloc((size_t)m*m*sizeof(double)); work.perm=malloc(m*sizeof(int));
+    head=malloc(m*sizeof(int)); base_head=malloc(m*sizeof(int));
+    stat=malloc(n+m); base_stat=malloc(n+m);
+    x=calloc(n+m,sizeof(double)); base_x=malloc((n+m)*sizeof(double));
+    eta=malloc((size_t)LPE_ETAMAX*m*sizeof(double)); eta_row=malloc(LPE_ETAMAX*sizeof(int));
+    vec=malloc(m*sizeof(double)); vec2=malloc(m*sizeof(double));
+    if(!ind || !val || !colstart || !rowidx || !colval || !lambda_col || !lb ||
+       !ub || !obj_row || !base.a || !base.perm || !work.a || !work.perm ||
+       !head || !base_head || !stat || !base_stat || !x || !base_x ||
+       !eta || !eta_row || !vec || !vec2){
+        free(ind); free(val); lpe_free(); return 1;
+    }
+    for(k=0;k<objs;k++) obj_row[k]=objidx[k+1]-1;
+    // columns; the lambda column is kept empty here
+    for(nnz=0,j=1;j<=n;j++){
+        colstart[j-1]=nnz;
+        if(j==lambda_idx) continue;
+        len=glp_get_mat_col(P,j,ind,val);
+        for(i=1;i<=len;i++){ rowidx[nnz]=ind[i]-1; colval[nnz]=val[i]; nnz++; }
+    }
+    colstart[n]=nnz;
+    free(ind); free(val);
+    // bounds and the basis found by glpk
+    basic=0;
+    for(k=0;k<n+m;k++){
+        if(k<n){
+            get_bounds(glp_get_col_type(P,k+1),glp_get_col_lb(P,k+1),
+                glp_get_col_ub(P,k+1),&lb[k],&ub[k]);
+            st=glp_get_col_stat(P,k+1);
+        } else {
+            get_bounds(glp_get_row_type(P,k-n+1),glp_get_row_lb(P,k-n+1),
+                glp_get_row_ub(P,k-n+1),&lb[k],&ub[k]);
+            st=glp_get_row_stat(P,k-n+1);
+        }
+        switch(st){
+          case GLP_BS: stat[k]=0; if(basic<m) head[basic]=k; basic++; break;
+          case GLP_NU: stat[k]=2; x[k]=ub[k]; break;
+          case GLP_NF: stat[k]=3; x[k]=0.0; break;
+          default:     stat[k]=1; x[k]=lb[k]; break; // GLP_NL, GLP_NS
+        }
+        if(stat[k] && (x[k]==HUGE_VAL || x[k]==-HUGE_VAL)){ stat[k]=3; x[k]=0.0; }
+    }
+    // lambda must be non-basic at zero
+    if(basic!=m || stat[lambda_var]!=1 || x[lambda_var]!=0.0){ lpe_free(); return 1; }
+    if(factorize(&base,head)){ lpe_free(); return 1; }
+    cur=&base; etano=0;
+    basic_values();
+    memcpy(base_head,head,m*sizeof(int));
+    memcpy(base_stat,stat,n+m);
+    memcpy(base_x,x,(n+m)*sizeof(double));
+    ready=1;
+    return 0;
+}
+
+/***********************************************************************
+* Primal simplex
+*
+* int pivot_limit(void)
+*    the number of pivots after which glpk is asked instead
+*/
+
+static inline int pivot_limit(void)
+{ return 4*(m+n)+50; }
+
+int lpe_solve(const double *lcol, double *lambda, double *dual)
+{int i,k,t,q,r,piv,dir,flip,degen; double d,dmax,step,tt,delta,amax;
+    if(!ready) return LPE_FAIL;
+    lpe_calls++;
+    memset(lambda_col,0,m*sizeof(double));
+    for(t=0;t<objs;t++) lambda_col[obj_row[t]]=lcol[t+1];
+    // start from the basis at the internal point
+    memcpy(head,base_head,m*sizeof(int));
+    memcpy(stat,base_stat,n+m);
+    memcpy(x,base_x,(n+m)*sizeof(double));
+    cur=&base; etano=0; degen=0;
+    for(piv=0;piv<=pivot_limit();piv++){
+        // duals: y*B = c_B, where c is one at lambda
+        for(i=0;i<m;i++) vec[i] = head[i]==lambda_var ? 1.0 : 0.0;
+        btran(vec);
+        // entering variable, largest reduced cost; the first one by Bland
+        q=-1; dmax=LPE_DUALTOL; dir=0;
+        for(k=0;k<n+m;k++) if(stat[k] && lb[k]<ub[k]){
+            d=(k==lambda_var ? 1.0 : 0.0)-dot_column(k,vec);
+            if(d>dmax && x[k]<ub[k]){ q=k; dmax=d; dir=1; }
+            else if(-d>dmax && x[k]>lb[k]){ q=k; dmax=-d; dir=-1; }
+            else continue;
+            if(degen>=LPE_DEGENMAX) break;
+        }
+        if(q<0){ // optimal
+            *lambda=x[lambda_var];
+            for(t=0;t<objs;t++) dual[t]=vec[obj_row[t]];
+            lpe_solved++; lpe_pivots += piv;
+            return LPE_OPT;
+        }
+        if(piv==pivot_limit()) break;
+        // ratio test on alpha = B^-1 a_q
+        column(q,vec2); memcpy(vec,vec2,m*sizeof(double));
+        ftran(vec);
+        step=ub[q]-lb[q]; r=-1; amax=0.0; flip=1; // bound flip
+        for(i=0;i<m;i++){
+            if(fabs(vec[i])<LPE_PIVTOL) continue;
+            delta=-dir*vec[i]; k=head[i];
+            if(delta<0.0 && lb[k]>-HUGE_VAL) tt=(x[k]-lb[k])/(-delta);
+            else if(delta>0.0 && ub[k]<HUGE_VAL) tt=(ub[k]-x[k])/delta;
+            else continue;
+            if(tt<0.0) tt=0.0;
+            if(tt<step-LPE_FEASTOL || (tt<step+LPE_FEASTOL &&
+               (degen<LPE_DEGENMAX ? fabs(vec[i])>amax : r<0 || k<head[r]))){
+                step=tt; r=i; amax=fabs(vec[i]); flip=0;
+            }
+        }
+        if(step==HUGE_VAL){ lpe_pivots += piv; lpe_solved++; return LPE_UNBND; }
+        if(step>LPE_FEASTOL) degen=0; else degen++;
+        // move along the edge
+        for(i=0;i<m;i++) x[head[i]] -= dir*vec[i]*step;
+        x[q] += dir*step;
+        if(flip){ stat[q] = dir>0 ? 2 : 1; x[q] = dir>0 ? ub[q] : lb[q]; continue; }
+        k=head[r]; // leaving variable goes to the bound it reached
+        if(-dir*vec[r]<0.0){ stat[k]=1; x[k]=lb[k]; } else { stat[k]=2; x[k]=ub[k]; }
+        head[r]=q; stat[q]=0;
+        if(etano<LPE_ETAMAX){
+            memcpy(eta+(size_t)etano*m,vec,m*sizeof(double));
+            eta_row[etano]=r; etano++;
+        } else { // factorize the actual basis
+            cur=&work; etano=0;
+            if(factorize(&work,head)) return LPE_FAIL;
+            basic_values();
+        }
+    }
+    lpe_pivots += piv;
+    return LPE_FAIL;
+}
+
+/* EOF */
+
@@ -0,0 +1,59 @@
+/** lpengine.h  --  native ray shooting LP engine **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Native oracle engine
+*
+* Oracle questions differ only in the lambda column of the LP. When
+* lambda is non-basic at zero, the basis found at the internal point
+* is feasible for every question. The engine keeps the LU factors of
+* that basis, and runs a bounded primal simplex from it for each
+* question; basis changes are recorded as eta columns on top of the
+* fixed factors. The factors are dense, thus only small LPs are
+* handled. When the engine cannot finish, glpk is called.
+*
+* int lpe_init(glp_prob *P, int lambda_idx, const int objidx[1:objs], int objs)
+*    copy the LP and the optimal basis from P after it was solved at
+*    the internal point. Return non-zero if the engine cannot be used
+*    for this problem; no error is reported. It can be called again
+*    after the LP has changed; statistics are kept.
+*
+* int lpe_solve(const double lcol[1:objs], double *lambda, double dual[0:objs-1])
+*    maximize lambda when the lambda column in the objective rows is
+*    lcol[]. Return LPE_OPT and store the optimal lambda and the
+*    duals of the objective rows; LPE_UNBND if lambda is unbounded;
+*    LPE_FAIL if the pivot limit was reached or the basis is singular.
+*
+* void lpe_release(void)
+*    free all memory and clear the statistics
+*
+* void get_lpe_stat(int *calls, int *solved, int *pivots, int *mismatch)
+*    questions given to the engine, those solved, the total number of
+*    pivots, and the answers which differed from glpk (OracleEngine=2).
+*
+* void lpe_mismatch(void)
+*    count an answer which differed from the glpk answer
+*/
+
+#define LPE_OPT		0	/* optimal solution found */
+#define LPE_UNBND	1	/* lambda is unbounded */
+#define LPE_FAIL	2	/* give up, ask glpk */
+
+int lpe_init(glp_prob *P, int lambda_idx, const int *objidx, int objs);
+int lpe_solve(const double *lcol, double *lambda, double *dual);
+void lpe_release(void);
+void get_lpe_stat(int *calls, int *solved, int *pivots, int *mismatch);
+void lpe_mismatch(void);
+
+/* EOF */
+
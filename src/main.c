@@ -64,7 +64,9 @@ int main(int argc, const char *argv[])
     if(r==1) return 0; /* job done */
     if(r<0) return 1;  /* data error */
     if(set_signals()) return 1; // handle signals
-    switch(outer()){ // execute the algorithm
+    switch(PARAMS(ReplayFile) ? replay() :
+           PARAMS(OracleBenchFile) ? oracle_bench() :
+           PARAMS(SweepFile) ? sweep() : outer()){ // execute the algorithm
       case 0:  return 0; /* job done */
       case 1:  return 1; /* data error before algorithm started */
       case 2:  return 3; /* problem unbounded */
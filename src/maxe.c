@@ -21,6 +21,11 @@
 #include "params.h"
 #include "poly.h"
 #include "glp_oracle.h"
+#include "ocache.h"
+#include "symmetry.h"
+#include "exchange.h"
+#include "control.h"
+#include "telemetry.h"
 #include "version.h"
 
 /*********************************************************************
@@ -55,8 +60,9 @@ inline static void initialize_random(void)
 /** the elapsed time in 0.01 seconds */
 unsigned long timenow=0;
 /** set timenow and return the elapsed time */
+static unsigned long starttime=0;
 static unsigned long gettime100(void)
-{struct timeval tv; static unsigned long starttime=0;
+{struct timeval tv;
     if(gettimeofday(&tv,NULL)) return timenow; // some problem
     if(starttime){
         timenow = (tv.tv_sec*100 + (tv.tv_usec+5000u)/10000u)-starttime;
@@ -104,12 +110,30 @@ static char* readable(double w, int slot)
 *    when was the last checkpoint created, minimum delay between
 *    two checkpoints
 *
-* int poolstat
-*    number of entries in FacetPool, set by find_next_facet()
+* int poolstat, poolsize
+*    number of entries in FacetPool, set by find_next_facet(). The
+*    first one is cleared by the progress report.
 *
 * int vertexstat
 *    whether vertex statistics changed calling add_new_vertex()
 *
+* double *sweepfacet, int sweepfacetno, sweepnext, sweepvariant
+*    facets of the previous sweep variant handed out as boot facets,
+*    their number, the next one, and the variant being solved
+*
+* int sweepfence
+*    facets below this index may have come from sweepfacet[]; they are
+*    checked by drop_improper_facets() before the result is saved
+*
+* int tunepool, tunelimit
+*    facet pool size and oracle call limit set by the auto tuner
+*
+* int tuneiter, double tuneoracle, tunedd
+*    iteration number, oracle and DD time at the last tuning step
+*
+* tunelog_t tunelog[TuneLogMax], int tunelogno, tunechanges
+*    the first changes made by the auto tuner, and their total number
+*
 * void progress_stat(void)
 *    show progress report, save the report time
 *
@@ -134,7 +158,24 @@ static char* readable(double w, int slot)
 static unsigned long progresstime=0, progressdelay=0;
 static unsigned long chktime=0, chkdelay=0;
 
-static int poolstat=0, vertexstat=0;
+static int poolstat=0, poolsize=0, vertexstat=0;
+
+static double *sweepfacet=NULL;
+static int sweepfacetno=0, sweepnext=0, sweepvariant=0, sweepfence=0;
+
+#define TuneLogMax	32	/* changes kept for the statistics */
+
+typedef struct {
+    int    iteration;	/* when the change was made */
+    int    pool;	/* new pool size */
+    int    limit;	/* new oracle call limit */
+    double ratio;	/* DD time / oracle time in the last window */
+} tunelog_t;
+
+static int tunepool=0, tunelimit=1;
+static int tuneiter=0; static double tuneoracle=0.0, tunedd=0.0;
+static tunelog_t tunelog[TuneLogMax];
+static int tunelogno=0, tunechanges=0;
 
 static void progress_stat(void)
 {   progresstime=timenow;
@@ -223,6 +264,18 @@ inline static int limit_reached(void)
 * EQSEP, DASHSEP
 *   separators made of = and -
 *
+* void print_oracle_hist(void)
+*   print percentiles of oracle call latency (in milliseconds) and
+*   simplex iterations by call outcome
+*
+* void print_edge_funnel(void)
+*   print how many vertex pairs passed the stages of the edge test;
+*   when there are several threads, print it for each thread
+*
+* void print_perf_counters(void)
+*   when PARAMS(PerfCounters) is set, print hardware counters in
+*   the hot phases
+*
 * void dump_and_save(int status)
 *   dump and save vertices and facets. The termination status:
 *     0  - normal
@@ -234,9 +287,96 @@ inline static int limit_reached(void)
 #define EQSEP   "================================"
 #define DASHSEP "--------------------------------"
 
+static void print_oracle_hist(void)
+{static const char *outcome[OH_MAX]={
+   "facet found","final vertex","retried","basis reset"};
+ double t[4],it[4]; int oh,calls,solved,pivots,mismatch;
+    report(R_txt,
+      " call latency (ms)         calls      p50      p90      p99      max\n");
+    for(oh=0;oh<OH_MAX;oh++){
+        calls=get_oracle_hist(oh,t,it);
+        if(calls==0) continue;
+        report(R_txt,"   %-20s %8d %8.3f %8.3f %8.3f %8.3f\n",outcome[oh],
+            calls,1e3*t[0],1e3*t[1],1e3*t[2],1e3*t[3]);
+    }
+    report(R_txt,
+      " simplex iterations        calls      p50      p90      p99      max\n");
+    for(oh=0;oh<OH_MAX;oh++){
+        if(oh==OH_reset) continue; // no iterations here
+        calls=get_oracle_hist(oh,t,it);
+        if(calls==0) continue;
+        report(R_txt,"   %-20s %8d %8.0f %8.0f %8.0f %8.0f\n",outcome[oh],
+            calls,it[0],it[1],it[2],it[3]);
+    }
+    if(get_engine_stat(&calls,&solved,&pivots,&mismatch)){
+        report(R_txt,
+          " native engine answers   %d of %d\n"
+          "   avg pivots/answer     %s\n",
+          solved,calls,readable((0.0001+pivots)/(0.0001+solved),0));
+        if(PARAMS(OracleEngine)==2) report(R_txt,
+          "   differs from glpk     %d\n",mismatch);
+    }
+}
+
+static void print_edge_funnel(void)
+{EDGE_FUNNEL ef; int th;
+    get_edge_funnel(-1,&ef);
+    report(R_txt,
+      " edge test funnel\n"
+      "   pairs tested          %s\n"
+      "   few common facets     %s\n"
+      "   full scans            %s\n",
+      readable((double)ef.pairs,0),readable((double)ef.few_common,1),
+      readable((double)ef.scans,2));
+    report(R_txt,
+      "   rejected by scan      %s\n"
+      "   edges found           %s\n"
+      "   new vertices          %s\n",
+      readable((double)ef.scan_reject,0),readable((double)ef.edges,1),
+      readable((double)ef.new_vertices,2));
+    if(PARAMS(Threads)<2) return;
+    report(R_txt,"   thread    pairs     scans     edges      work      wait\n");
+    for(th=0;th<PARAMS(Threads);th++){
+        get_edge_funnel(th,&ef);
+        report(R_txt,"   %4d  %9s %9s %9s",th,readable((double)ef.pairs,0),
+            readable((double)ef.scans,1),readable((double)ef.edges,2));
+        report(R_txt," %9s",showtime((unsigned long)(100.0*phase_total(th,PH_edges))));
+        report(R_txt," %9s\n",showtime((unsigned long)(100.0*phase_total(th,PH_barrier))));
+    }
+}
+
+static void print_perf_counters(void)
+{static const phase_t phases[]={PH_oracle,PH_probe,PH_classify,PH_search,PH_edges};
+ double cnt[PC_MAX]; int i,header;
+    if(!PARAMS(PerfCounters)) return;
+    header=0;
+    for(i=0;i<(int)(sizeof(phases)/sizeof(phases[0]));i++){
+        if(!get_perf_counters(phases[i],cnt)) continue;
+        if(!header){ header=1; report(R_txt,
+          " hardware counters\n"
+          "   phase        cycles     instr    IPC   LLC miss  dTLB miss   br miss\n");
+        }
+        report(R_txt,"   %-9s %9s %9s",phase_name(phases[i]),
+            readable(cnt[PC_cycles],0),readable(cnt[PC_instructions],1));
+        if(cnt[PC_cycles]>0.0 && cnt[PC_instructions]>=0.0)
+            report(R_txt," %6.2f",cnt[PC_instructions]/cnt[PC_cycles]);
+        else report(R_txt,"      -");
+        report(R_txt," %10s %10s %9s\n",
+            cnt[PC_llc_misses]<0.0 ? "-" : readable(cnt[PC_llc_misses],0),
+            cnt[PC_dtlb_misses]<0.0 ? "-" : readable(cnt[PC_dtlb_misses],1),
+            cnt[PC_branch_misses]<0.0 ? "-" : readable(cnt[PC_branch_misses],2));
+    }
+    if(!header) report(R_txt," hardware counters       not available\n");
+}
+
 static void dump_and_save(int status)
-{unsigned long endtime; int partial;
+{unsigned long endtime; int partial,n;
     endtime=gettime100(); // program finished
+    if(status!=2 && sweepfence>PARAMS(ProblemObjects)+1){ // seeded hyperplanes may not be facets
+        n=drop_improper_facets(PARAMS(ProblemObjects)+1,sweepfence); sweepfence=0;
+        if(n) report(R_info,"C sweep variant %d, %d seeded facets are not facets, dropped\n",
+            sweepvariant,n);
+    }
     if(PARAMS(ProgressReport)) progress_stat();
     partial= status==0 ? 0 : 1; // print data when completed
     if(PARAMS(PrintVertices) > partial){
@@ -275,6 +415,9 @@ static void dump_and_save(int status)
       PARAMS(SaveFacetFile) ? "\n" : "",
       PARAMS(ProblemRows), PARAMS(ProblemColumns), PARAMS(ProblemObjects),
       get_vertexnum(), get_facetnum());
+      if(PARAMS(SweepFile)) report(R_txt,
+        " sweep variant           %d, %d boot facets\n",
+        sweepvariant,sweepfacetno);
       report(R_txt, " total time              %s\n",
          showtime(endtime)); 
       report(R_txt, DASHSEP "\nStatistics\n"
@@ -284,6 +427,32 @@ static void dump_and_save(int status)
       " total oracle time       %s\n",
       oraclecalls, readable((0.0001+oraclerounds)/(0.0001+oraclecalls),0),
       showtime(oracletime));
+      print_oracle_hist();
+      if(PARAMS(OracleCacheFile)){
+        int lookups,hits,stored,full;
+        get_ocache_stat(&lookups,&hits,&stored,&full);
+        report(R_txt,
+        " oracle cache hits       %d of %d (%.1f%%)\n"
+        "   answers stored        %d%s\n",
+        hits,lookups,lookups>0 ? 100.0*(double)hits/(double)lookups : 0.0,
+        stored,full>0 ? ", cache is full" : "");
+      }
+      if(symmetry_generators()){
+        int queued,added,saved,truncated;
+        get_symmetry_stat(&queued,&added,&saved,&truncated);
+        report(R_txt,
+        " symmetric facets added  %d of %d images\n"
+        "   oracle calls saved    %d%s\n",
+        added,queued,saved,truncated>0 ? ", some orbits truncated" : "");
+      }
+      if(PARAMS(ExchangeDir)){
+        int exported,imported,duplicate,files;
+        get_exchange_stat(&exported,&imported,&duplicate,&files);
+        report(R_txt,
+        " facets exported         %d\n"
+        "   imported              %d from %d files, %d duplicates\n",
+        exported,imported,files,duplicate);
+      }
       report(R_txt,
       "Combinatorics\n"
       " vertices probed         %d\n"
@@ -297,6 +466,38 @@ static void dump_and_save(int status)
 #ifdef USETHREADS
       report(R_txt, " threads                 %d\n",PARAMS(Threads));
 #endif      
+      if(PARAMS(ScoreSample)>0) report(R_txt,
+      " pool scored by sampling %d times\n",dd_stats.probesampled);
+      if(PARAMS(SealVertices)){
+        get_dd_vertexno(); // fills sealed_vertex_no
+        report(R_txt,
+        " sealed vertices         %d, left out %.0f times\n",
+        dd_stats.sealed_vertex_no,dd_stats.sealed_skipped);
+      }
+      if(PARAMS(VertexBoxes) && dd_stats.boxtests>0.0) report(R_txt,
+      " vertex boxes decided    %.1f%% of %.0f tests, rebuilt %d times\n",
+      100.0*dd_stats.boxskipped/dd_stats.boxtests,dd_stats.boxtests,
+      dd_stats.boxrebuilt);
+      if(PARAMS(AutoTune) && PARAMS(FacetPoolSize)>=5){
+        int i;
+        report(R_txt,
+        " auto tuning             %d changes, pool %d, call limit %d\n",
+        tunechanges,tunepool,tunelimit);
+        if(tunelogno>0) report(R_txt,
+        "   iteration   pool  limit  dd/oracle\n");
+        for(i=0;i<tunelogno;i++) report(R_txt,"   %9d %6d %6d %10.3f\n",
+          tunelog[i].iteration,tunelog[i].pool,tunelog[i].limit,tunelog[i].ratio);
+        if(tunechanges>tunelogno) report(R_txt,"   ... %d more changes\n",
+          tunechanges-tunelogno);
+      }
+      if(PARAMS(Workers)>1){
+        int rounds,merged,redone;
+        get_worker_stat(&rounds,&merged,&redone);
+        report(R_txt,
+        " worker processes        %d, used in %d iterations\n"
+        "   vertices merged       %d%s\n",
+        PARAMS(Workers),rounds,merged,redone>0 ? ", some shards redone" : "");
+      }
       if(dd_stats.instability_warning) report(R_txt,
       " instability warnings    %d\n",
       dd_stats.instability_warning);
@@ -314,6 +515,8 @@ static void dump_and_save(int status)
       readable(dd_stats.avg_vertexadded,0),readable(dd_stats.max_vertexadded,1),
       dd_stats.vertex_compressed_no,
       readable(dd_stats.avg_tests,2),readable(dd_stats.max_tests,3));
+      print_edge_funnel();
+      print_perf_counters();
       if(PARAMS(MemoryReport)>0 || dd_stats.out_of_memory)
          report_memory_usage(R_txt,1,"Memory allocation:");
       if(PARAMS(PrintParams))
@@ -331,6 +534,7 @@ static void dump_and_save(int status)
           PARAMS(ProblemName), 
           PARAMS(ProblemRows), PARAMS(ProblemColumns), PARAMS(ProblemObjects),
           get_vertexnum(), get_facetnum());
+        if(PARAMS(SweepFile)) report(R_savefacet,"C sweep variant %d\n",sweepvariant);
         if(status) report(R_savefacet,"C *** Partial list of facets ***\n");
         print_facets(R_savefacet);
         report(R_savefacet,"\n");
@@ -341,6 +545,7 @@ static void dump_and_save(int status)
           PARAMS(ProblemName), 
           PARAMS(ProblemRows), PARAMS(ProblemColumns), PARAMS(ProblemObjects),
           get_vertexnum(), get_facetnum());
+        if(PARAMS(SweepFile)) report(R_savevertex,"C sweep variant %d\n",sweepvariant);
         if(status) report(R_savevertex,"C *** Partial list of vertices ***\n");
         print_vertices(R_savevertex);
         report(R_savevertex,"\n");
@@ -354,7 +559,12 @@ static void dump_and_save(int status)
 * int FacetPoolAfter = 20
 * int FacetPoolMinVertices = 1000
 *   use facetpool only when we have at least that many facets, or
-*   that many unprocessed vertices
+*   that many unprocessed vertices; the auto tuner ignores them
+*
+* int PoolSize, CallLimit
+*   the facet pool size and oracle call limit in effect; when
+*   PARAMS(AutoTune) is set, they are chosen by autotune() up to
+*   PARAMS(FacetPoolSize) and PARAMS(OracleCallLimit)
 *   
 * facetpool_t facetpool[FacetPoolSize]
 *   facets known but not added yet to the approximation.
@@ -375,13 +585,19 @@ static void dump_and_save(int status)
 *   vertex returned by get_next_vertex(-1). Check whether the vertex has
 *   been asked before if checkFacetPool is set. If the returned
 *   facet is on the vertex, mark the vertex as final and repeat.
+*   Vertices in the orbit of a final vertex are marked final without
+*   asking the oracle; when filling the facet pool, vertices cut off
+*   by a queued symmetric image are skipped. The images of a new facet
+*   are queued by symmetry_new_facet(), and the facet is exported to
+*   the other processes by exchange_new_facet().
 *   Return value:
 *     0:  there are no more vertices, the algorithm finished
 *     1:  interrupted
 *     4:  some error (oracle failed, computational error, etc)
 *     5:  next (random) vertex is already in FacetPool (only
 *            if checkFacetPool!=0)
-*     6:  next facet is in OracleData.ofacet (maybe from bootfile)
+*     6:  next facet is in OracleData.ofacet (maybe from bootfile,
+*            from the previous sweep variant, or from another process)
 *     7:  memory or time limit exceeded
 *
 * int fill_facetpool(int limit)
@@ -394,14 +610,24 @@ static void dump_and_save(int status)
 *
 * int find_next_facet(void)
 *   find the next facet to be added to the approximating polytope.
-*   Without facet pool it calls next_facet_coords().
+*   Queued symmetric images of earlier facets come first. Without
+*   facet pool it calls next_facet_coords().
 *   Otherwise returns the facet with the largest probe_facet(v)
 *   score. Return values are the same as for next_facet_coords().
+*
+* int score_pool_sampled(int *cnt)
+*   score the pool by probe_facets() which samples the vertices when
+*   PARAMS(ScoreSample) is set. Store the number of pool entries in
+*   cnt, and return the index of the best one; -1 if the pool is
+*   empty, -2 if out of memory.
 */
 
 #define FacetPoolAfter 20  /* use vertexpool only after that many facets */
 #define FacetPoolMinVertices 1000 /* or after that many unprocessed vertices */
 
+#define PoolSize	(PARAMS(AutoTune) ? tunepool : PARAMS(FacetPoolSize))
+#define CallLimit	(PARAMS(AutoTune) ? tunelimit : PARAMS(OracleCallLimit))
+
 typedef struct {
     int    occupied;    /* 0=no, 1=yes */
     double *vertex;     /* pointer to vertex which was asked */
@@ -431,6 +657,29 @@ static int init_facetpool(void) /* call only when DIM has been set */
     return 0;
 }
 
+/* int resize_facetpool(int oldsize)
+*    FacetPoolSize has changed from oldsize; keep the occupied entries
+*    which fit into the new pool. Return non-zero if out of memory, then
+*    the old pool and size are kept. */
+static int resize_facetpool(int oldsize)
+{facetpool_t *old; int i,j;
+    old=facetpool; facetpool=NULL;
+    if(init_facetpool()){
+        free(facetpool); // the pool itself could not be allocated
+        facetpool=old; PARAMS(FacetPoolSize)=oldsize;
+        return 1;
+    }
+    if(!old) return 0;
+    for(i=j=0;i<oldsize && facetpool && j<PARAMS(FacetPoolSize);i++) if(old[i].occupied){
+        memcpy(facetpool[j].vertex,old[i].vertex,(DIM+1)*sizeof(double));
+        memcpy(facetpool[j].facet,old[i].facet,(DIM+1)*sizeof(double));
+        facetpool[j].occupied=1; j++;
+    }
+    free(old[0].vertex); free(old);
+    if(tunepool>PARAMS(FacetPoolSize)) tunepool=facetpool ? PARAMS(FacetPoolSize) : 0;
+    return 0;
+}
+
 inline static int same_vector(int dim, const double f1[], const double f2[])
 {int i; double d;
     for(i=0;i<dim;i++){
@@ -459,16 +708,40 @@ again:
    purged from the pool. */
         return 6; /* facet is OK */
     }
+    // facets of the previous sweep variant, skip those which do not cut
+    while(sweepnext<sweepfacetno){
+        memcpy(OracleData.ofacet,sweepfacet+sweepnext*(DIM+1),(DIM+1)*sizeof(double));
+        sweepnext++;
+        if(probe_facet(OracleData.ofacet)==0) continue;
+        memset(OracleData.overtex,0,(DIM+1)*sizeof(double));
+        sweepfence=get_facetnum()+1; // it is added as the next facet
+        return 6;
+    }
+    // facets found by other processes, skip those which do not cut
+    while(exchange_next_facet(OracleData.ofacet)){
+        if(probe_facet(OracleData.ofacet)==0) continue;
+        memset(OracleData.overtex,0,(DIM+1)*sizeof(double));
+        return 6;
+    }
     j=get_next_vertex(-1,OracleData.overtex);
     if(j<0) return 0; /* terminated successfully */
     if(checkFacetPool){ /* ask oracle only when not asked before */
-        for(i=0;i<PARAMS(FacetPoolSize);i++) if(facetpool[i].occupied
+        for(i=0;i<PoolSize;i++) if(facetpool[i].occupied
            && same_vector(DIM+1,facetpool[i].vertex,OracleData.overtex)){
             return 5; // vertex in OracleData.overtex was asaked before
         }
+        if(symmetry_cut(OracleData.overtex)) return 5; // an image cuts it off
+    }
+    if(symmetry_is_final(OracleData.overtex)){ // image of a final vertex
+        mark_vertex_as_final(j);
+        report_new_vertex(j);
+        goto again;
     }
+    phase_begin(0,PH_oracle);
     i=ask_oracle();
+    phase_end(0,PH_oracle);
     if(i==ORACLE_UNBND){ // on the boundary
+        symmetry_final_vertex(OracleData.overtex);
         mark_vertex_as_final(j);
         report_new_vertex(j);// progress_stat_if_expired(1);
         goto again;
@@ -513,12 +786,14 @@ again:
         report_new_vertex(j);// progress_stat_if_expired(1);
         goto again;
     }
+    symmetry_new_facet(OracleData.ofacet);
+    exchange_new_facet(OracleData.ofacet);
     return 6;
 }
 
 static int fill_facetpool(int limit)
 {int i,ii; int oracle_calls=0;
-    for(i=0;i<PARAMS(FacetPoolSize);i++)if(!facetpool[i].occupied)
+    for(i=0;i<PoolSize;i++)if(!facetpool[i].occupied)
         switch(next_facet_coords(1)){
       case 0:  return 0; /* no more vertices or done */
       case 1:  return 1; /* break */
@@ -526,9 +801,9 @@ static int fill_facetpool(int limit)
       case 7:  return 7; /* memory or time limit */
       case 5:  break;    /* the vertex has been encoutered again, skip */
       default:           /* 6, facet is in OracleData */
-            for(ii=0;ii<PARAMS(FacetPoolSize);ii++) if(facetpool[ii].occupied
+            for(ii=0;ii<PoolSize;ii++) if(facetpool[ii].occupied
                && same_vector(DIM,OracleData.ofacet,facetpool[ii].facet)) break;
-            if(ii==PARAMS(FacetPoolSize)){ // the facet is not in FacetPool
+            if(ii==PoolSize){ // the facet is not in FacetPool
                 memcpy(facetpool[i].vertex,OracleData.overtex,(DIM+1)*sizeof(double));
                 memcpy(facetpool[i].facet,OracleData.ofacet,(DIM+1)*sizeof(double));
                 facetpool[i].occupied=1;
@@ -543,22 +818,44 @@ static int fill_facetpool(int limit)
     return 0;
 }
 
+static int score_pool_sampled(int *cnt)
+{double **f; int *idx,*score; int i,n,best;
+    f=malloc(PoolSize*sizeof(double *));
+    idx=malloc(PoolSize*sizeof(int)); score=malloc(PoolSize*sizeof(int));
+    if(!f || !idx || !score){ free(f); free(idx); free(score); return -2; }
+    for(n=0,i=0;i<PoolSize;i++) if(facetpool[i].occupied){
+        f[n]=facetpool[i].facet; idx[n]=i; n++;
+    }
+    probe_facets(n,f,score);
+    for(best=-1,i=0;i<n;i++) if(best<0 || score[best]<score[i]) best=i;
+    if(best>=0) best=idx[best];
+    free(f); free(idx); free(score);
+    *cnt=n;
+    return best;
+}
+
 static int find_next_facet(void)
 {int i,maxi,cnt; int w,maxw;
-    if(PARAMS(FacetPoolSize)<5 || ( dd_stats.facetno<FacetPoolAfter &&
+    if(symmetry_next_facet(OracleData.ofacet)) return 6;
+    if(PoolSize<5 || ( !PARAMS(AutoTune) && dd_stats.facetno<FacetPoolAfter &&
       dd_stats.vertex_zero+dd_stats.vertex_pos+dd_stats.vertex_new<FacetPoolMinVertices))
        return next_facet_coords(0);
     // fill the facet pool
-    i=fill_facetpool(PARAMS(OracleCallLimit));
+    i=fill_facetpool(CallLimit);
     if(i) return i; // some error
     /* find the score of stored facets */
     maxi=-1; maxw=0; cnt=0;
-    for(i=0;i<PARAMS(FacetPoolSize);i++) if(facetpool[i].occupied){
+    phase_begin(0,PH_probe);
+    if(PARAMS(ScoreSample)<=0 || (maxi=score_pool_sampled(&cnt))<-1){
+      maxi=-1;
+      for(i=0;i<PoolSize;i++) if(facetpool[i].occupied){
         cnt++;
         w=probe_facet(facetpool[i].facet);
         if(maxi<0 || maxw<w){ maxi=i; maxw=w; }
+      }
     }
-    poolstat=cnt;
+    phase_end(0,PH_probe);
+    poolstat=cnt; poolsize=cnt;
     if(maxi<0) return 0; // no more vertices
     facetpool[maxi].occupied=0;
     memcpy(OracleData.ofacet,facetpool[maxi].facet,(DIM+1)*sizeof(double));
@@ -570,7 +867,8 @@ static int find_next_facet(void)
 * int outer(void)
 *   when it starts, all parameters in PARAMS have been set. The steps are
 *   o  load_vlp() reads in the the MOLP problem form a vlp file
-*   o  check that output files are writable
+*   o  check that output files are writable, open the oracle cache,
+*        read the symmetry generators
 *   o  initilize_oracle_() sets the oracle parameters, check feasibility
 *   o  the first approximation comes from two sources. The "resume"
 *        file contains facets (first) and non-ideal vertices (those marked
@@ -596,6 +894,9 @@ static int find_next_facet(void)
 *     3:  no feasible solution
 *     4:  computational error (filling vertex pool, initial data, out of memory)
 *     5-7: from break_outer()
+*   The same steps are available one by one through the maxe_*() calls
+*   declared in maxe.h: outer() calls maxe_create(), maxe_load_vlp(),
+*   maxe_step() while it returns -1, and finally maxe_destroy().
 *
 * void report_error(void)
 *   report error fatal error
@@ -609,10 +910,17 @@ static int find_next_facet(void)
 *     6:  error during postprocess
 *     7:  postprocessing aborted
 *
+* void autotune(void)
+*   after every TuneWindow iterations compare the time spent by the
+*   oracle (including scoring the pool) to the time of the DD steps in
+*   the window. When DD steps are more expensive by TuneRatio, a larger
+*   pool and call limit pay off as the best facet cuts more vertices;
+*   when the oracle is more expensive, shrink them.
+*
 * int handle_new_facet(void)
 *   the new facet is in OracleData.ofacet; make reports, add as a new 
 *   facet by calling add_new_facet(), take care of timed actions such as
-*   reports and checkpoints.
+*   reports and checkpoints. Write the telemetry record.
 *   Return values:
 *     1:  OK
 *     0:  error during computation (cannot continue)
@@ -662,8 +970,16 @@ static int break_outer(int status)
                 return 7; // postprocess aborted
             }
         }
+        if(symmetry_is_final(OracleData.overtex)){
+            mark_vertex_as_final(j);
+            report_new_vertex(j);
+            continue;
+        }
+        phase_begin(0,PH_oracle);
         i=ask_oracle();
+        phase_end(0,PH_oracle);
         if(i==ORACLE_UNBND){ // on the boundary
+            symmetry_final_vertex(OracleData.overtex);
             mark_vertex_as_final(j);
             report_new_vertex(j);
         } else if(i!=ORACLE_OK) {
@@ -675,12 +991,51 @@ static int break_outer(int status)
     return 5; // terminated
 }
 
+#define TuneWindow	50	/* iterations between two tuning steps */
+#define TuneRatio	2.0	/* change when the costs differ that much */
+
+static void autotune(void)
+{double orc,dd,ratio; int pool,limit,maxlimit,i;
+    if(!PARAMS(AutoTune) || !facetpool) return;
+    if(dd_stats.iterations-tuneiter<TuneWindow) return;
+    orc=phase_total(0,PH_oracle)+phase_total(0,PH_probe);
+    dd=phase_total(0,PH_classify)+phase_total(0,PH_search)+phase_total(0,PH_update);
+    ratio=(dd-tunedd)/(orc-tuneoracle+1e-6);
+    tuneiter=dd_stats.iterations; tuneoracle=orc; tunedd=dd;
+    maxlimit=PARAMS(OracleCallLimit)>0 ? PARAMS(OracleCallLimit) : MAX_OCALL_LIMIT;
+    pool=tunepool; limit=tunelimit;
+    if(ratio>TuneRatio){ // DD is expensive, use a larger pool
+        pool = pool<5 ? 5 : pool+(pool+1)/2;
+        limit++;
+    } else if(ratio<1.0/TuneRatio){ // oracle is expensive
+        pool -= pool/3; if(pool<5) pool=0;
+        limit--;
+    }
+    if(pool>PARAMS(FacetPoolSize)) pool=PARAMS(FacetPoolSize);
+    if(limit>maxlimit) limit=maxlimit;
+    if(limit<1) limit=1;
+    if(pool==tunepool && limit==tunelimit) return;
+    for(i=pool;i<tunepool;i++) facetpool[i].occupied=0; // drop these
+    tunepool=pool; tunelimit=limit;
+    if(tunelogno<TuneLogMax){
+        tunelog[tunelogno].iteration=dd_stats.iterations;
+        tunelog[tunelogno].pool=pool; tunelog[tunelogno].limit=limit;
+        tunelog[tunelogno].ratio=ratio; tunelogno++;
+    }
+    tunechanges++;
+    report(R_info,"I%8.2f] auto tune: pool %d, call limit %d (dd/oracle %.3f)\n",
+        0.01*(double)timenow,pool,limit,ratio);
+}
+
 static int handle_new_facet(void)
 {   report_new_facet(0);  // progress report
     add_new_facet(OracleData.ofacet);
     gettime100(); vertexstat=1; progress_stat_if_expired(0);
     if(dd_stats.out_of_memory || dd_stats.numerical_error)
         return 0; // error meanwhile
+    telemetry_iteration(poolsize);
+    livestat_update(poolsize);
+    autotune();
     vertices_recalculated=0;
     // recalculate if instructed so
     if(PARAMS(RecalculateVertices)>=5 &&
@@ -714,17 +1069,51 @@ typedef enum {	/* where data come from */
   inp_resume	/* facets and vertices from --resume */
 } input_type_t;
 
-int outer(void)
-{int retvalue=0; input_type_t inp_type=inp_none;
+/* struct maxe_t
+*    state of the outer loop. The data of the other modules are
+*    global, thus there is a single instance which is handed out by
+*    maxe_create() when not in use. */
+struct maxe_t {
+    int          loaded;	/* maxe_load_vlp() was successful */
+    int          threads;	/* threads have been created */
+    int          finished;	/* the main loop has finished */
+    int          retvalue;	/* return value when finished */
+    input_type_t inp_type;	/* where the first approximation comes from */
+};
+
+static maxe_t maxe_instance;
+static int maxe_in_use=0;
+
+maxe_t *maxe_create(void)
+{   if(maxe_in_use){
+        report(R_fatal,"maxe_create: another problem is being solved\n");
+        return NULL;
+    }
+    maxe_in_use=1;
+    memset(&maxe_instance,0,sizeof(maxe_instance));
+    starttime=0; timenow=0; progresstime=0; chktime=0;
+    poolstat=0; poolsize=0; vertexstat=0; vertices_recalculated=0;
+    tunepool=0; tunelimit=1; tuneiter=0; tuneoracle=0.0; tunedd=0.0;
+    tunelogno=0; tunechanges=0;
+    return &maxe_instance;
+}
+
+int maxe_load_vlp(maxe_t *m)
+{
+    if(m->loaded) return 0;
     initialize_random();  // initialize random numbers
     if(load_vlp()) return 1; // data error before start
     if(check_outfiles()) return 1;
+    if(ocache_open()) return 1;
+    if(symmetry_init()) return 1;
+    if(exchange_init()) return 1;
+    if(control_open()) return 1;
     if(PARAMS(BootFile)){ // we have a bootfile
         if(init_reading(PARAMS(BootFile))) return 1; 
-        inp_type=inp_boot;
+        m->inp_type=inp_boot;
     } else if(PARAMS(ResumeFile)){
         if(init_reading(PARAMS(ResumeFile))) return 1;
-        inp_type=inp_resume;
+        m->inp_type=inp_resume;
     }
     report(R_info,"C MAXE problem=%s, %s\n"
         "C rows=%d, columns=%d, objectives=%d\n",
@@ -739,7 +1128,7 @@ int outer(void)
       default:		return 4; // oracle error, message given
     }
     chkdelay = 100*(unsigned long)PARAMS(CheckPoint);
-    if(inp_type==inp_resume){ // read initial polytope from ResumeFile
+    if(m->inp_type==inp_resume){ // read initial polytope from ResumeFile
         int linetype=0; double args[5];
         if(!nextline(&linetype) || linetype!=4 || parseline(5,&args[0])){
             report(R_fatal,"Resume: missing N line in file '%s'\n",
@@ -781,45 +1170,484 @@ int outer(void)
         if(init_dd_structure(0,0)) return 1;
         init_dd();  // create the first approximation
     }
+    if(livestat_open()) return 1;
+    open_telemetryfile(); // before any worker thread writes to it
 #ifdef USETHREADS
     if(create_threads()) return 1;
+    m->threads=1;
 #endif
     chktime=gettime100(); // last checktime
     progress_stat_if_expired(0);
-again:
+    m->loaded=1;
+    return 0;
+}
+
+/* void maxe_leave(maxe_t *m)
+*    the main loop has finished with m->retvalue */
+static void maxe_leave(maxe_t *m)
+{
+#ifdef USETHREADS
+    if(m->threads) stop_threads();
+#endif
+    m->threads=0;
+    write_trace();
+    livestat_close(m->retvalue);
+    m->finished=1;
+}
+
+/* void handle_control(maxe_t *m)
+*    execute the commands arrived on the control channel. Keywords are
+*    changed by change_parameter(); the values derived from them are
+*    updated here. */
+static void handle_control(maxe_t *m)
+{const char *cmd; int oldpool,r; char hdr[80];
+#ifdef USETHREADS
+ int oldthreads;
+#else
+    (void)m; // only needed when threads are restarted
+#endif
+    while((cmd=control_next())!=NULL){
+        if(strcmp(cmd,"stop")==0){
+            dobreak++;
+        } else if(strcmp(cmd,"checkpoint")==0){
+            phase_begin(0,PH_checkpoint);
+            if(PARAMS(CheckPointStub)){ chktime=timenow; make_checkpoint(); }
+            else make_dump();
+            phase_end(0,PH_checkpoint);
+        } else if(strcmp(cmd,"show")==0){
+            sprintf(hdr,"I%08.2f] Parameters with non-default values:\n",
+                0.01*(double)timenow);
+            show_parameters(hdr);
+        } else {
+#ifdef USETHREADS
+            oldthreads=PARAMS(Threads);
+#endif
+            oldpool=PARAMS(FacetPoolSize);
+            r=change_parameter(cmd);
+            if(r<=0){
+                report(R_warn,"control: %s: %s\n",cmd,
+                    r<0 ? "value is out of range" : "unknown command");
+                continue;
+            }
+            progressdelay = 100*(unsigned long)PARAMS(ProgressReport);
+            chkdelay = 100*(unsigned long)PARAMS(CheckPoint);
+            if(PARAMS(FacetPoolSize)!=oldpool && resize_facetpool(oldpool)){
+                report(R_warn,"control: %s: out of memory\n",cmd);
+                continue;
+            }
+#ifdef USETHREADS
+            if(PARAMS(Threads)!=oldthreads){
+                r=PARAMS(Threads); PARAMS(Threads)=oldthreads;
+                if(m->threads) stop_threads();
+                PARAMS(Threads)=r; m->threads=0;
+                if(create_threads()){ dobreak++; continue; } // stop gracefully
+                m->threads=1;
+            }
+#endif
+        }
+        report(R_info,"I%08.2f] control: %s\n",0.01*(double)timenow,cmd);
+        flush_report();
+    }
+}
+
+int maxe_step(maxe_t *m)
+{
+    if(!m->loaded) return 1;
+    if(m->finished) return m->retvalue;
     gettime100();
+    handle_control(m);
     if(dodump){ // request for dump
         dodump=0;
         report(R_info,"I%08.2f] Dumping vertices and facets\n",0.01*(double)timenow);
+        phase_begin(0,PH_checkpoint);
         make_dump();
+        phase_end(0,PH_checkpoint);
+        write_trace();
     }
     if(PARAMS(CheckPointStub) && chktime+chkdelay<=timenow){
         chktime=timenow;
         report(R_info,"I%08.2f] Checkpoint: dumping vertices and facets\n",
             0.01*(double)chktime);
+        phase_begin(0,PH_checkpoint);
         make_checkpoint();
+        phase_end(0,PH_checkpoint);
     }
     switch(find_next_facet()){
       case 0: /* no more facets */
-        dump_and_save(0); retvalue=0; goto leave;
+        dump_and_save(0); m->retvalue=0; break;
       case 1: /* interrupt */
-        retvalue=break_outer(0);
-        dump_and_save(3); goto leave;
+        m->retvalue=break_outer(0);
+        dump_and_save(3); break;
       case 4: /* numerical or other error */
         report_error();
-        dump_and_save(2); retvalue=4; goto leave;
+        dump_and_save(2); m->retvalue=4; break;
       case 7: /* memory or time limit */
-        retvalue=break_outer(1);
-        dump_and_save(3); goto leave;
+        m->retvalue=break_outer(1);
+        dump_and_save(3); break;
       default: /* next facet returned */
-        if(handle_new_facet()) goto again;
+        if(handle_new_facet()) return -1; // continue
         dump_and_save(dd_stats.data_is_consistent? 1 : 2);
-        retvalue=4; goto leave;
+        m->retvalue=4; break;
     }
-leave:
+    maxe_leave(m);
+    return m->retvalue;
+}
+
+int maxe_get_vertices(maxe_t *m, maxe_vertex_fn *fn, void *arg)
+{int vno,r,n; double *v;
+    if(!m->loaded) return -1;
+    v=malloc((DIM+1)*sizeof(double));
+    if(!v) return -1;
+    for(n=0,vno=0;(r=get_vertex(vno,v))>=0;vno++) if(r>0){
+        fn(arg,r==2,v); n++;
+    }
+    free(v);
+    return n;
+}
+
+int maxe_get_facets(maxe_t *m, maxe_facet_fn *fn, void *arg)
+{int fno; double *f;
+    if(!m->loaded) return -1;
+    f=malloc((DIM+1)*sizeof(double));
+    if(!f) return -1;
+    for(fno=0;get_facet(fno,f)>0;fno++) fn(arg,f);
+    free(f);
+    return fno;
+}
+
+void maxe_destroy(maxe_t *m)
+{
+    if(m!=&maxe_instance) return;
+    if(m->loaded && !m->finished) maxe_leave(m);
+    close_savefiles();
+    free_dd_structure();
+    symmetry_release();
+    exchange_close();
+    control_close();
+    ocache_close();
+    release_oracle();
+    telemetry_reset();
+    if(facetpool){ free(facetpool[0].vertex); free(facetpool); facetpool=NULL; }
+    maxe_in_use=0;
+}
+
+int outer(void)
+{maxe_t *m; int retvalue;
+    m=maxe_create();
+    if(!m) return 1;
+    retvalue=maxe_load_vlp(m);
+    if(retvalue==0) while((retvalue=maxe_step(m))<0);
+    maxe_destroy(m);
+    return retvalue;
+}
+
+/***********************************************************************
+* Parametric sweep
+*
+* int collect_facets(void)
+*    copy the facets of the finished variant to sweepfacet[] in the
+*    internal direction. The DIM+1 facets of the first approximation
+*    are skipped. Return 1 if out of memory.
+*
+* int restart_variant(maxe_t *m)
+*    the LP has been changed by apply_vlp_variant(). Move the collected
+*    facets so that they support the new polytope and drop those which
+*    are not valid any more; check the internal point starting from the
+*    previous basis; set up the first approximation. Return value is
+*    the same as for maxe_load_vlp().
+*/
+
+static int collect_facets(void)
+{int fno,n; double *f;
+    n=get_facetnum();
+    f=realloc(sweepfacet,(n+1)*(DIM+1)*sizeof(double));
+    if(!f){ report(R_fatal,"sweep: out of memory\n"); return 1; }
+    sweepfacet=f; sweepfacetno=0; sweepnext=0;
+    for(fno=DIM+1;fno<n && get_facet(fno,f)>0;fno++){
+        if(PARAMS(Direction)) f[DIM] = -f[DIM];
+        f += DIM+1; sweepfacetno++;
+    }
+    return 0;
+}
+
+static int restart_variant(maxe_t *m)
+{int i,n; double *f;
+    free_dd_structure();
+    symmetry_release();
+    if(symmetry_init()) return 1;
+    if(facetpool) for(i=0;i<PARAMS(FacetPoolSize);i++) facetpool[i].occupied=0;
+    for(n=0,i=0;i<sweepfacetno;i++){
+        f=sweepfacet+i*(DIM+1);
+        switch(facet_support(f)){
+          case ORACLE_OK:    break;
+          case ORACLE_UNBND: continue; // not valid any more
+          case ORACLE_EMPTY:
+            report(R_fatal,"Sweep variant %d has no feasible solution\n",sweepvariant);
+            return 3;
+          default:           return 4; // oracle error, message given
+        }
+        if(n<i) memcpy(sweepfacet+n*(DIM+1),f,(DIM+1)*sizeof(double));
+        n++;
+    }
+    report(R_info,"C sweep variant %d, %d of %d facets are kept\n",
+        sweepvariant,n,sweepfacetno);
+    sweepfacetno=n; sweepnext=0; sweepfence=0;
+    switch(reinitialize_oracle()){
+      case ORACLE_OK:	break;	  // OK
+      case ORACLE_EMPTY:return 3; // no feasible solution
+      default:		return 4; // oracle error, message given
+    }
+    if(init_dd_structure(0,0)) return 1;
+    init_dd();
+    vertices_recalculated=0; poolstat=0; poolsize=0; vertexstat=0;
+    m->finished=0; m->retvalue=0;
+    if(livestat_open()) return 1;
+    open_telemetryfile(); // before any worker thread writes to it
+#ifdef USETHREADS
+    if(create_threads()) return 1;
+    m->threads=1;
+#endif
+    chktime=gettime100();
+    progress_stat_if_expired(0);
+    return 0;
+}
+
+int sweep(void)
+{maxe_t *m; FILE *f; int retvalue;
+    f=fopen(PARAMS(SweepFile),"r");
+    if(!f){
+        report(R_fatal,"Cannot open sweep file %s for reading\n",PARAMS(SweepFile));
+        return 1;
+    }
+    m=maxe_create();
+    if(!m){ fclose(f); return 1; }
+    sweepvariant=0; sweepfacetno=0; sweepnext=0; sweepfence=0;
+    retvalue=maxe_load_vlp(m);
+    while(retvalue==0){
+        while((retvalue=maxe_step(m))<0);
+        if(retvalue) break; // interrupted or error
+        if(collect_facets()){ retvalue=4; break; }
+        retvalue=apply_vlp_variant(f,PARAMS(SweepFile));
+        if(retvalue<0){ retvalue=0; break; } // no more variants
+        if(retvalue) break;
+        sweepvariant++;
+        retvalue=restart_variant(m);
+    }
+    fclose(f);
+    maxe_destroy(m);
+    free(sweepfacet); sweepfacet=NULL; sweepfacetno=0; sweepnext=0;
+    return retvalue;
+}
+
+/***********************************************************************
+* Replay benchmark
+*
+* int replay_facet(double f[0:DIM])
+*    normalize the facet read from an F line so that the absolute
+*    values of the first DIM coefficients add up to 1, and undo the
+*    sign change of the constant when maximizing. Return 1 if the
+*    facet is one of the DIM+1 facets of the initial approximation
+*    which should be skipped.
+*
+* void replay_report(int added, int skipped, double elapsed)
+*    print the replay statistics
+*/
+
+static int replay_facet(double *f)
+{int i,nonzero; double w;
+    w=0.0; nonzero=0;
+    for(i=0;i<DIM;i++){
+        if(f[i]!=0.0) nonzero++;
+        w += f[i]<0.0 ? -f[i] : f[i];
+    }
+    if(w<PARAMS(PolytopeEps)) return 1; // the ideal facet
+    for(i=0;i<=DIM;i++) f[i] /= w;
+    if(PARAMS(Direction)) f[DIM] = -f[DIM];
+    if(nonzero==1 && f[DIM]==0.0) return 1; // coordinate facet
+    return 0;
+}
+
+static void replay_report(int added, int skipped, double elapsed)
+{static const phase_t phases[]={PH_classify,PH_search,PH_update,PH_edges,PH_barrier};
+ int i,th; double t;
+    if(!PARAMS(PrintStatistics)) return;
+    report(R_txt,"\n" DASHSEP "\n"
+      "Replay %s\n"
+      " name                    %s\n"
+      " facets from             %s\n"
+      " rows, cols, objs        %d, %d, %d\n"
+      " facets added, skipped   %d, %d\n"
+      " vertices, facets        %d, %d\n"
+      " total time              %.3f\n"
+      " facets/second           %s\n",
+      dobreak ? "interrupted" : dd_stats.out_of_memory || dd_stats.numerical_error ?
+         "aborted with error" : "completed",
+      PARAMS(ProblemName),PARAMS(ReplayFile),
+      PARAMS(ProblemRows),PARAMS(ProblemColumns),PARAMS(ProblemObjects),
+      added,skipped,get_vertexnum(),get_facetnum(),elapsed,
+      readable(elapsed>0.0 ? (double)added/elapsed : 0.0,0));
+    report(R_txt," phase times\n");
+    for(i=0;i<(int)(sizeof(phases)/sizeof(phases[0]));i++){
+        for(t=0.0,th=0;th<(PARAMS(Threads)>1 ? PARAMS(Threads) : 1);th++)
+            t += phase_total(th,phases[i]);
+        report(R_txt,"   %-21s %.3f\n",phase_name(phases[i]),t);
+    }
+    report(R_txt,
+      " vertices # max          %d\n"
+      " vertex manipulating\n"
+      "   added avg / max       %s / %s\n"
+      " number of edge tests\n"
+      "   avg / max             %s / %s\n",
+      dd_stats.max_vertices,
+      readable(dd_stats.avg_vertexadded,0),readable(dd_stats.max_vertexadded,1),
+      readable(dd_stats.avg_tests,2),readable(dd_stats.max_tests,3));
+    print_edge_funnel();
+    print_perf_counters();
+    if(PARAMS(MemoryReport)>0 || dd_stats.out_of_memory)
+        report_memory_usage(R_txt,1,"Memory allocation:");
+}
+
+int replay(void)
+{int linetype,added,skipped,retvalue; double *facet,start,elapsed;
+    if(load_vlp_header()) return 1;
+    if(check_outfiles()) return 1;
+    if(init_reading(PARAMS(ReplayFile))) return 1;
+    facet=malloc((DIM+1)*sizeof(double));
+    if(!facet){ report(R_fatal,"replay: out of memory\n"); return 1; }
+    report(R_info,"C MAXE replay of %s, problem=%s, %s\n"
+        "C rows=%d, columns=%d, objectives=%d\n",
+        PARAMS(ReplayFile),PARAMS(ProblemName),
+        PARAMS(Direction)?"maximize":"minimize",
+        PARAMS(ProblemRows),PARAMS(ProblemColumns),PARAMS(ProblemObjects));
+    gettime100(); // initialize elapsed time
+    progressdelay = 100*(unsigned long)PARAMS(ProgressReport);
+    if(init_dd_structure(0,0)) return 1;
+    init_dd();
+    if(livestat_open()) return 1;
+    open_telemetryfile(); // before any worker thread writes to it
+#ifdef USETHREADS
+    if(create_threads()) return 1;
+#endif
+    added=0; skipped=0; retvalue=0;
+    start=phase_clock();
+    while(nextline(&linetype)) if(linetype==3){ // F line
+        if(dobreak || limit_reached()){ retvalue=5; break; }
+        if(parseline(DIM+1,facet)){
+            report(R_fatal,"replay: wrong F line in %s\n",PARAMS(ReplayFile));
+            retvalue=4; break;
+        }
+        if(replay_facet(facet)){ skipped++; continue; }
+        add_new_facet(facet);
+        if(dd_stats.out_of_memory || dd_stats.numerical_error){
+            report_error(); retvalue=4; break;
+        }
+        added++;
+        vertexstat=1; progress_stat_if_expired(1);
+        telemetry_iteration(0);
+        livestat_update(0);
+    }
+    elapsed=phase_clock()-start;
+    if(PARAMS(ProgressReport)){ gettime100(); progress_stat(); }
+    replay_report(added,skipped,elapsed);
 #ifdef USETHREADS
     stop_threads();
 #endif
+    write_trace();
+    livestat_close(retvalue);
+    close_savefiles();
+    free(facet);
+    return retvalue;
+}
+
+/***********************************************************************
+* Oracle benchmark
+*
+* double ORACLE_AGREE_EPS
+*    recorded and actual facet coefficients agree if they differ by
+*    less than this value
+*/
+
+#define ORACLE_AGREE_EPS	1e-6
+
+int oracle_bench(void)
+{int linetype,queries,asked,agree,status_differ,facet_differ,failed;
+ int i,ret,retvalue,oraclecalls,oraclerounds; unsigned long oracletime;
+ const char *oracleversion; double *answer,d,start,elapsed;
+    if(load_vlp()) return 1;
+    if(check_outfiles()) return 1;
+    if(init_reading(PARAMS(OracleBenchFile))) return 1;
+    answer=malloc((DIM+2)*sizeof(double));
+    if(!answer){ report(R_fatal,"oracle-bench: out of memory\n"); return 1; }
+    report(R_info,"C MAXE oracle benchmark of %s, problem=%s, %s\n"
+        "C rows=%d, columns=%d, objectives=%d\n",
+        PARAMS(OracleBenchFile),PARAMS(ProblemName),
+        PARAMS(Direction)?"maximize":"minimize",
+        PARAMS(ProblemRows),PARAMS(ProblemColumns),PARAMS(ProblemObjects));
+    switch(initialize_oracle()){  // initialize oracle
+      case ORACLE_OK:	break;	  // OK
+      case ORACLE_EMPTY:free(answer); return 3; // no feasible solution
+      default:		free(answer); return 4; // oracle error, message given
+    }
+    queries=asked=agree=status_differ=facet_differ=failed=0;
+    ret=-1; retvalue=0;
+    start=phase_clock();
+    while(nextline(&linetype)){
+        if(dobreak){ retvalue=5; break; }
+        if(linetype==5){ // Q line
+            if(parseline(DIM+1,OracleData.overtex)){ retvalue=1; break; }
+            queries++;
+            phase_begin(0,PH_oracle);
+            ret=ask_oracle();
+            phase_end(0,PH_oracle);
+            if(ret==ORACLE_FAIL) failed++;
+        } else if(linetype==6 && ret>=0){ // A line after a Q line
+            if(parseline(DIM+2,answer)){ retvalue=1; break; }
+            asked++;
+            if((int)answer[0]!=ret) status_differ++;
+            else if(ret==ORACLE_OK){
+                for(i=0;i<=DIM;i++){
+                    d=OracleData.ofacet[i]-answer[i+1];
+                    if(d>ORACLE_AGREE_EPS || d<-ORACLE_AGREE_EPS) break;
+                }
+                if(i<=DIM) facet_differ++; else agree++;
+            } else agree++;
+            ret=-1;
+        }
+    }
+    elapsed=phase_clock()-start;
+    if(PARAMS(PrintStatistics)){
+        get_oracle_stat(&oraclecalls,&oraclerounds,&oracletime,&oracleversion);
+        report(R_txt,"\n" DASHSEP "\n"
+          "Oracle benchmark %s\n"
+          " algorithm               " PROGNAME " " mkstringof(VERSION_MAJOR.VERSION_MINOR) " %s\n"
+          " name                    %s\n"
+          " queries from            %s\n"
+          " rows, cols, objs        %d, %d, %d\n"
+          " total time              %.3f\n"
+          " queries                 %d\n"
+          "   failed                %d\n"
+          "   answers compared      %d\n"
+          "   agree                 %d\n"
+          "   outcome differs       %d\n"
+          "   facet differs         %d\n",
+          retvalue ? "interrupted" : "completed",oracleversion,
+          PARAMS(ProblemName),PARAMS(OracleBenchFile),
+          PARAMS(ProblemRows),PARAMS(ProblemColumns),PARAMS(ProblemObjects),
+          elapsed,queries,failed,asked,agree,status_differ,facet_differ);
+        report(R_txt,"LP\n"
+          " oracle calls            %d\n"
+          "   avg iterations/call   %s\n"
+          " total oracle time       %s\n",
+          oraclecalls, readable((0.0001+oraclerounds)/(0.0001+oraclecalls),0),
+          showtime(oracletime));
+        print_oracle_hist();
+        print_perf_counters();
+        if(PARAMS(PrintParams))
+            show_parameters("Parameters with non-default values:\n");
+    }
+    write_trace();
+    close_savefiles();
+    free(answer);
     return retvalue;
 }
 
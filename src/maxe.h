@@ -29,5 +29,99 @@
 
 int outer(void);
 
+/***********************************************************************
+* Step by step interface
+*
+* The algorithm can be embedded into other programs. This is a
+* restartable single-instance API, not an isolated solver context:
+* parameters are taken from the global PARAMS(), and all modules keep
+* their data in global variables. Only one problem can be solved at a
+* time in a process, and only from one thread. Solving several
+* problems at once would need the module data moved into the handle;
+* this is not done. After maxe_destroy() the next problem can be
+* solved with fresh statistics. The handle only tracks how far the
+* outer loop has got.
+*
+* maxe_t *maxe_create(void)
+*    return the handle of the single solver instance, or NULL if it
+*    is in use.
+*
+* int maxe_load_vlp(maxe_t *m)
+*    read PARAMS(VlpFile), initialize the oracle and the first
+*    approximation. Return 0 if OK, otherwise the return value of
+*    outer() (1 to 4).
+*
+* int maxe_step(maxe_t *m)
+*    add the next facet to the approximation. Return -1 if the
+*    algorithm should continue; otherwise it has finished, the result
+*    has been saved, and the return value is the same as for outer().
+*
+* int maxe_get_vertices(maxe_t *m, maxe_vertex_fn *fn, void *arg)
+*    call fn(arg,final,coords[0:dim]) for each vertex of the actual
+*    approximation; 'final' is set if the vertex is known to be final.
+*    Return the number of vertices, or -1 on error.
+*
+* int maxe_get_facets(maxe_t *m, maxe_facet_fn *fn, void *arg)
+*    call fn(arg,coords[0:dim]) for each facet of the approximation.
+*    Return the number of facets, or -1 on error.
+*
+* void maxe_destroy(maxe_t *m)
+*    stop threads, close files, release the memory of the modules
+*    including the LP instance, and clear the statistics: the edge
+*    funnel, the phase timers, the hardware counters and the trace
+*    events.
+*/
+
+typedef struct maxe_t maxe_t;
+typedef void maxe_vertex_fn(void *arg, int final, const double *coords);
+typedef void maxe_facet_fn(void *arg, const double *coords);
+
+maxe_t *maxe_create(void);
+int maxe_load_vlp(maxe_t *m);
+int maxe_step(maxe_t *m);
+int maxe_get_vertices(maxe_t *m, maxe_vertex_fn *fn, void *arg);
+int maxe_get_facets(maxe_t *m, maxe_facet_fn *fn, void *arg);
+void maxe_destroy(maxe_t *m);
+
+/***********************************************************************
+* Parametric sweep
+*
+* int sweep(void)
+*    solve the problem, then each variant in PARAMS(SweepFile) which
+*    changes the bounds and the internal point of the loaded LP. The
+*    facets of the previous variant, moved to support the new polytope,
+*    are used as boot facets; the LP starts from the previous basis.
+*    Boot facets which touch the new polytope only in a lower
+*    dimensional face are dropped before the result is saved.
+*    Stop at the first variant which does not finish normally. Return
+*    value is the same as for outer().
+*/
+
+int sweep(void);
+
+/***********************************************************************
+* Replay benchmark
+*
+* int replay(void)
+*    add the facets recorded in PARAMS(ReplayFile) to the approximation
+*    using the double description method only; the oracle and glpk are
+*    not used. Report facets per second and phase timings. Return
+*    value is the same as for outer().
+*/
+
+int replay(void);
+
+/***********************************************************************
+* Oracle benchmark
+*
+* int oracle_bench(void)
+*    ask the oracle questions recorded in PARAMS(OracleBenchFile) in
+*    the same order, and compare the answers to the recorded ones.
+*    Report latency, iterations and the agreement. Return value is
+*    the same as for outer().
+*/
+
+int oracle_bench(void);
+
 /* EOF */
 
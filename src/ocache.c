@@ -0,0 +1,214 @@
+/** ocache.c  --  persistent cache of oracle answers **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>	/* offsetof() */
+#include <unistd.h>	/* ftruncate(), pread(), pwrite() */
+#include <fcntl.h>	/* open() */
+#include <sys/file.h>	/* flock() */
+#include <sys/mman.h>	/* mmap() */
+#include <sys/stat.h>	/* fstat() */
+#include "report.h"
+#include "params.h"
+#include "hashkey.h"
+#include "glp_oracle.h"
+#include "ocache.h"
+
+/***********************************************************************
+* Cache file layout
+*
+* The file starts with a header of 64 bytes followed by 'slots'
+* entries of 'entrysize' bytes each. An entry is empty when its key is
+* zero. A process claims an empty entry by a compare-and-swap on the
+* key, fills the rest, and finally sets 'ready'. Readers ignore
+* entries which are not ready. Entries are never removed; the file can
+* be deleted when it is not in use.
+*
+* OCACHE_MAGIC, OCACHE_VERSION
+*    the first 8 bytes of the file and the layout version
+*
+* OCACHE_PROBES
+*    maximal number of entries checked by linear probing
+*/
+
+#define OCACHE_MAGIC	"MAXEOCCH"
+#define OCACHE_VERSION	1
+#define OCACHE_PROBES	64
+
+typedef struct {
+    char     magic[8];		/* OCACHE_MAGIC */
+    uint32_t version;		/* OCACHE_VERSION */
+    uint32_t dim;		/* dimension; entries have dim+1 coefficients */
+    uint64_t slots;		/* number of entries */
+    uint64_t entrysize;		/* size of an entry in bytes */
+    volatile uint64_t used;	/* entries used */
+    char     pad[24];		/* header is 64 bytes */
+} ocache_header_t;
+
+typedef struct {
+    volatile uint64_t key;	/* primary hash, 0 if empty */
+    uint64_t check;		/* secondary hash */
+    volatile int32_t ready;	/* 1 if the answer is filled */
+    int32_t  outcome;		/* ORACLE_OK or ORACLE_UNBND */
+    double   facet[1];		/* facet[0..dim] */
+} ocache_entry_t;
+
+/***********************************************************************
+* Cache data
+*
+* ocache_header_t *OCache
+*    the mapped file, or NULL when there is no cache
+*
+* size_t ocache_size
+*    size of the mapped file
+*
+* uint64_t vlp_hash
+*    FNV-1a hash of the vlp file content and of the settings which
+*    change the answer; vertex keys are computed by vector_key() of
+*    hashkey.c starting from it
+*
+* int ocache_lookups, ocache_hits, ocache_stored, ocache_full
+*    statistics
+*/
+
+static ocache_header_t *OCache=NULL;
+static size_t ocache_size=0;
+static uint64_t vlp_hash=0;
+static int ocache_lookups=0, ocache_hits=0, ocache_stored=0, ocache_full=0;
+
+#define DIM		PARAMS(ProblemObjects)
+
+#define ocache_entry(i)	\
+    ((ocache_entry_t *)(((char *)OCache)+sizeof(ocache_header_t)+(i)*OCache->entrysize))
+
+/***********************************************************************
+* Opening the cache file
+*/
+
+int ocache_open(void)
+{int fd; struct stat st; ocache_header_t hdr; void *page; size_t entrysize;
+    if(!PARAMS(OracleCacheFile)) return 0;
+    if(hash_vlp(&vlp_hash)){
+        report(R_fatal,"Oracle cache: cannot read vlp file %s\n",PARAMS(VlpFile));
+        return 1;
+    }
+    entrysize=offsetof(ocache_entry_t,facet)+(DIM+1)*sizeof(double);
+    fd=open(PARAMS(OracleCacheFile),O_RDWR|O_CREAT,0644);
+    if(fd<0){
+        report(R_fatal,"Oracle cache: cannot open %s\n",PARAMS(OracleCacheFile));
+        return 1;
+    }
+    flock(fd,LOCK_EX); // other processes wait until the file is initialized
+    if(fstat(fd,&st)){ st.st_size=0; }
+    if(st.st_size==0){ // new file
+        memset(&hdr,0,sizeof(hdr));
+        memcpy(hdr.magic,OCACHE_MAGIC,8);
+        hdr.version=OCACHE_VERSION;
+        hdr.dim=DIM;
+        hdr.slots=1000ull*(uint64_t)PARAMS(OracleCacheSize);
+        hdr.entrysize=entrysize;
+        if(ftruncate(fd,sizeof(hdr)+hdr.slots*entrysize) ||
+           pwrite(fd,&hdr,sizeof(hdr),0)!=(ssize_t)sizeof(hdr)){
+            flock(fd,LOCK_UN); close(fd);
+            report(R_fatal,"Oracle cache: cannot create %s\n",PARAMS(OracleCacheFile));
+            return 1;
+        }
+    } else if(pread(fd,&hdr,sizeof(hdr),0)!=(ssize_t)sizeof(hdr)
+       || memcmp(hdr.magic,OCACHE_MAGIC,8)!=0 || hdr.version!=OCACHE_VERSION
+       || (off_t)(sizeof(hdr)+hdr.slots*hdr.entrysize)>st.st_size){
+        flock(fd,LOCK_UN); close(fd);
+        report(R_fatal,"Oracle cache: %s is not a cache file\n",PARAMS(OracleCacheFile));
+        return 1;
+    } else if(hdr.dim!=(uint32_t)DIM || hdr.entrysize!=entrysize){
+        flock(fd,LOCK_UN); close(fd);
+        report(R_fatal,"Oracle cache: %s was created for dimension %u\n",
+            PARAMS(OracleCacheFile),hdr.dim);
+        return 1;
+    }
+    ocache_size=sizeof(hdr)+hdr.slots*hdr.entrysize;
+    page=mmap(NULL,ocache_size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+    flock(fd,LOCK_UN); close(fd); // the mapping is kept
+    if(page==MAP_FAILED){
+        report(R_fatal,"Oracle cache: cannot map %s\n",PARAMS(OracleCacheFile));
+        return 1;
+    }
+    OCache=(ocache_header_t *)page;
+    return 0;
+}
+
+void ocache_close(void)
+{   if(OCache) munmap(OCache,ocache_size);
+    OCache=NULL; ocache_size=0;
+    ocache_lookups=ocache_hits=ocache_stored=ocache_full=0;
+}
+
+/***********************************************************************
+* Lookup and store
+*/
+
+int ocache_lookup(const double *vertex, double *facet)
+{uint64_t key,check,idx; int i; ocache_entry_t *e;
+    if(!OCache) return -1;
+    ocache_lookups++;
+    vector_key(vertex,0,vlp_hash,&key,&check);
+    idx=key%OCache->slots;
+    for(i=0;i<OCACHE_PROBES;i++){
+        e=ocache_entry(idx);
+        if(e->key==0) return -1; // not stored
+        if(e->key==key && e->check==check){
+            if(!e->ready) return -1; // being filled
+            __sync_synchronize();
+            memcpy(facet,e->facet,(DIM+1)*sizeof(double));
+            ocache_hits++;
+            return e->outcome;
+        }
+        idx++; if(idx>=OCache->slots) idx=0;
+    }
+    return -1;
+}
+
+void ocache_store(const double *vertex, int outcome, const double *facet)
+{uint64_t key,check,idx,k; int i; ocache_entry_t *e;
+    if(!OCache) return;
+    vector_key(vertex,0,vlp_hash,&key,&check);
+    idx=key%OCache->slots;
+    for(i=0;i<OCACHE_PROBES;i++){
+        e=ocache_entry(idx);
+        k=e->key;
+        if(k==0 && __sync_bool_compare_and_swap(&e->key,0,key)){
+            e->check=check;
+            e->outcome=outcome;
+            memcpy(e->facet,facet,(DIM+1)*sizeof(double));
+            __sync_synchronize();
+            e->ready=1;
+            __sync_fetch_and_add(&OCache->used,1);
+            ocache_stored++;
+            return;
+        }
+        k=e->key; // somebody might have claimed it meanwhile
+        if(k==key && e->check==check) return; // already there
+        idx++; if(idx>=OCache->slots) idx=0;
+    }
+    ocache_full++;
+}
+
+void get_ocache_stat(int *lookups, int *hits, int *stored, int *full)
+{   *lookups=ocache_lookups; *hits=ocache_hits;
+    *stored=ocache_stored; *full=ocache_full;
+}
+
+/* EOF */
+
@@ -0,0 +1,53 @@
+/** ocache.h  --  persistent cache of oracle answers **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Oracle answer cache
+*
+* Answers of the oracle are stored in a memory mapped file given by
+* the option --oracle-cache=<file>. Entries are keyed by the hash of
+* the vlp file content and the quantized question vertex, thus the same
+* file can be used by later runs with different settings, or by
+* several processes at the same time.
+*
+* int ocache_open(void)
+*    when PARAMS(OracleCacheFile) is set, open or create the cache file
+*    with PARAMS(OracleCacheSize) thousand entries, and map it into
+*    the memory. Return non-zero if the file cannot be used; the
+*    error is reported.
+*
+* void ocache_close(void)
+*    unmap the cache file and clear the statistics
+*
+* int ocache_lookup(const double vertex[0:dim], double facet[0:dim])
+*    look up the question. If found, copy the facet and return the
+*    stored outcome ORACLE_OK or ORACLE_UNBND; otherwise return -1.
+*
+* void ocache_store(const double vertex[0:dim], int outcome,
+*        const double facet[0:dim])
+*    store the answer of the oracle. When the table is full, the
+*    answer is not stored.
+*
+* void get_ocache_stat(int *lookups, int *hits, int *stored, int *full)
+*    number of lookups and hits, entries stored by this process, and
+*    answers not stored as the table was full.
+*/
+
+int ocache_open(void);
+void ocache_close(void);
+int ocache_lookup(const double *vertex, double *facet);
+void ocache_store(const double *vertex, int outcome, const double *facet);
+void get_ocache_stat(int *lookups, int *hits, int *stored, int *full);
+
+/* EOF */
+
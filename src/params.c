@@ -27,22 +27,31 @@
 #define DEF_OraclePricing	1	/* STD / steepest */
 #define DEF_OracleRatioTest	1	/* STD / Harris */
 #define DEF_OracleScale		1	/* scale */
+#define DEF_OracleEngine	0	/* glpk */
 #define DEF_ShuffleMatrix	1	/* yes */
 #define DEF_RoundFacets		1	/* yes */
+#define DEF_OracleCacheSize	100	/* thousand entries */
 /* DD parameters */
 #define DEF_RandomVertex	1	/* yes */
 #define DEF_ExactVertex		0	/* no */
+#define DEF_VertexBoxes		0	/* no */
+#define DEF_SealVertices	0	/* no */
 #define DEF_RecalculateVertices	100
 #define DEF_CheckConsistency	0
 #define DEF_ExtractAfterBreak	1	/* yes */
+#define DEF_Symmetry		1	/* yes */
+#define DEF_AutoTune		0	/* no */
 #define DEF_MemoryLimit		0	/* unlimited */
 #define DEF_TimeLimit		0	/* unlimited */
 /* vertex pool */
 #define DEF_FacetPoolSize	0	/* don't use facet pool */
 #define DEF_CheckPoint		10000	/* delay for creating dumps */
 #define DEF_OracleCallLimit	1	/* stop after the first unsuccessful call */
+#define DEF_ExchangeDelay	5	/* in seconds */
+#define DEF_ScoreSample		0	/* exact scoring */
 /* number of threads */
 #define DEF_Threads		0	/* number of threads */
+#define DEF_Workers		0	/* no worker processes */
 /* randomness */
 #define DEF_TrueRandom		1	/* yes */
 /* Tolerances */
@@ -64,6 +73,8 @@
 #define DEF_PrintFacets		1	/* don't report */
 #define DEF_SaveVertices	1	/* partial */
 #define DEF_SaveFacets		2	/* always */
+#define DEF_TelemetrySample	1	/* every iteration */
+#define DEF_PerfCounters	0	/* no */
 struct params_t GlobalParams;
 
 /***********************************************************************
@@ -99,6 +110,14 @@ CFG( ExactVertex, BOOL)
 "#    when a vertex is created, recompute coordinates from the set\n"
 "#    of adjacent facets.\n"
 "#\n"
+CFG( VertexBoxes, BOOL)
+"#    keep the vertices in a hierarchy of bounding boxes; vertices in\n"
+"#    a box on one side of a facet are classified by a single test.\n"
+"#\n"
+CFG( SealVertices, BOOL)
+"#    leave final vertices whose neighbours are all final out of the\n"
+"#    edge search and facet probing, they cannot be cut off.\n"
+"#\n"
 CFG( RecalculateVertices, INTEGER)
 "#    after that many iterations recalculate all vertex coordinates\n"
 "#    from the set of adjacent facets. Should be zero (never), or at\n"
@@ -115,6 +134,10 @@ CFG( ExtractAfterBreak, BOOL)
 "#    of the actual approximating polyhedron. Can be very time\n"
 "#    consuming. Second signal aborts this post-processing.\n"
 "#\n"
+CFG( Symmetry, BOOL)
+"#    use the permutations of the objectives declared in the vlp file\n"
+"#    or by the option --symmetry=<file>; see --help=symmetry.\n"
+"#\n"
 CFG( MemoryLimit, INTEGER)
 "#    upper limit for memory allocation, in Mbytes. When reaching this limit,\n"
 "#    stop processing as if received a "  mkstringof(BREAK_SIGNAL) " signal. Zero\n"
@@ -144,12 +167,36 @@ CFG( OracleCallLimit, INTEGER )
 "#    iteration when filling the facet pool. Zero means no limit;\n"
 "#    otherwise should be less than " mkstringof(MAX_OCALL_LIMIT)  ".\n"
 "#\n"
+CFG( ScoreSample, INTEGER)
+"#    when scoring the facet pool, estimate the number of vertices cut\n"
+"#    off by a facet from a stratified sample of about that many living\n"
+"#    vertices. The sample is extended when the best facets are close.\n"
+"#    Zero means exact scoring, which is also used when there are less\n"
+"#    than four times that many vertices. Otherwise at least 100.\n"
+"#\n"
+CFG( AutoTune, BOOL)
+"#    adjust the facet pool size and the oracle call limit during the\n"
+"#    run comparing the time spent by the oracle and by the DD steps.\n"
+"#    FacetPoolSize and OracleCallLimit are used as upper bounds.\n"
+"#\n"
+CFG( ExchangeDelay, POSINT)
+"#    time in seconds between two facet exchanges with other processes\n"
+"#    when the option --exchange=<dir> is given; see --help=exchange.\n"
+"#\n"
 #ifdef USETHREADS
 CFG( Threads, INTEGER)
 "#    number of threads to use; should be less than " mkstringof(MAX_THREADS) ". Zero means\n"
 "#    use as many as are available; 1 means don't use threads.\n"
 "#\n"
 #endif
+CFG( Workers, INTEGER)
+"#    number of processes testing the vertex pairs of large iterations;\n"
+"#    should be less than " mkstringof(MAX_WORKERS) ". Zero or 1 means don't fork workers.\n"
+"#    Workers get a copy-on-write snapshot of the whole approximation\n"
+"#    and return the new vertices in shared memory; memory is not split\n"
+"#    among them. Useful when maxe is compiled without threads; not\n"
+"#    used when Threads is more than 1.\n"
+"#\n"
 "##########################\n"
 "#   ORACLE parameters    #\n"
 "##########################\n"
@@ -175,6 +222,14 @@ CFG( OracleItLimit, INTEGER)
 CFG( OracleScale, BOOL)
 "#    scale the constraint matrix; helps numerical stability.\n"
 "#\n"
+CFG( OracleEngine, "0 = glpk, 1 = native, 2 = both and compare")
+"#    the LP engine answering oracle questions. The native engine keeps\n"
+"#    the basis at the internal point and changes only the lambda\n"
+"#    column; questions it cannot answer are passed to glpk. It handles\n"
+"#    small LPs only, and it is switched off when a sample of its answers\n"
+"#    is slower than glpk. With 2 both are asked, the glpk answer is\n"
+"#    used, and differences are counted.\n"
+"#\n"
 CFG( ShuffleMatrix, BOOL)
 "#    shuffle the rows and columns of the constraint matrix randomly.\n"
 "#\n"
@@ -182,6 +237,10 @@ CFG( RoundFacets, BOOL)
 "#    when the oracle reports a result facet, round its coordinates\n"
 "#    to the nearest rational with small denominator.\n"
 "#\n"
+CFG( OracleCacheSize, POSINT)
+"#    number of entries in a new oracle cache file in thousands; see\n"
+"#    the option --oracle-cache=<file>.\n"
+"#\n"
 "##########################\n"
 "#       REPORTING        #\n"
 "##########################\n"
@@ -234,6 +293,15 @@ CFG( SaveFacets, BOOL2)
 "#    specified after '-of' both 0 and 1 means \"save on normal\n"
 "#    exit only\".\n"
 "#\n"
+CFG( TelemetrySample, POSINT)
+"#    when the option -ot <file> is given, write a telemetry record\n"
+"#    to <file> after that many iterations. See --help=telemetry.\n"
+"#\n"
+CFG( PerfCounters, BOOL)
+"#    count cycles, instructions, cache, TLB and branch misses in the\n"
+"#    hot phases using hardware counters and print them with the\n"
+"#    statistics. Linux only; see --help=telemetry.\n"
+"#\n"
 "##########################\n"
 "#       TOLERANCES       #\n"
 "##########################\n"
@@ -309,7 +377,9 @@ static void long_help(void){ printf(
 "  -h               display a short help\n"
 "  --help           display all options\n"
 "  --help=<topic>   choose one of the following topics: input,output,\n"
-"                     exit,config,boot,checkpoint,resume,signal,vlp\n"
+"                     exit,config,boot,checkpoint,resume,signal,vlp,\n"
+"                     telemetry,benchmark,symmetry,sweep,exchange,\n"
+"                     control\n"
 "  --version        version and copyright information\n"
 "  --dump           dump the default config file and quit\n"
 "  --config=<config-file>\n"
@@ -323,11 +393,25 @@ static void long_help(void){ printf(
 "  -ov <file>       save vertices to <file>\n"
 "  -of <file>       save facets to <file>\n"
 "  -oc <filestub>   file stub for checkpoint files\n"
+"  -ot <file>       write telemetry records to <file>\n"
+"  -oe <file>       write trace events of the main phases to <file>\n"
+"  -os <file>       publish live statistics in <file>, see maxe-stat\n"
+"  -oq <file>       record oracle queries and answers to <file>\n"
 "  -p T             progress report in every T seconds (default: T=5)\n"
 "  -p 0             no progress report\n"
 "  -q               quiet, same as -m0. Implies --PrintStatistics=0\n"
 "  --resume=<checkpoint-file>\n"
 "                   resume computation\n"
+"  --replay=<file>  benchmark: add facets from <file> without the oracle\n"
+"  --oracle-bench=<file>\n"
+"                   benchmark: ask the oracle queries recorded in <file>\n"
+"  --oracle-cache=<file>\n"
+"                   keep oracle answers in <file> for later runs\n"
+"  --symmetry=<file>\n"
+"                   read generators of the symmetry group from <file>\n"
+"  --sweep=<file>   solve the variants of the problem listed in <file>\n"
+"  --exchange=<dir> share facets with other processes through <dir>\n"
+"  --control=<fifo> accept commands from the named pipe <fifo>\n"
 "  -y+              report facets immediately when generated (default)\n"
 "  -y-              do not report facets when generated\n"
 "  --KEYWORD=value  change value of a config keyword (see --dump)\n"
@@ -345,6 +429,12 @@ static void topic_help(void) {printf(
 "  resume     resume computation from a checkpoint or snapshot\n"
 "  boot       specify a set of precomputed facets\n"
 "  vlp        syntax of a vlp file\n"
+"  telemetry  machine readable statistics of each iteration\n"
+"  benchmark  replay recorded facets or oracle queries\n"
+"  symmetry   permutations of the objectives which keep the solution\n"
+"  sweep      solve a family of problems differing in bounds only\n"
+"  exchange   share facets between processes solving the same problem\n"
+"  control    change parameters of a running job\n"
 );}
 
 static void vlp_help(void) {printf(
@@ -515,6 +605,190 @@ static void resume_help(void) {printf(
 "parameters can be set differently.\n"
 );}
 
+static void telemetry_help(void) {printf(
+"******************************\n"
+"***    Telemetry records   ***\n"
+"******************************\n"
+"\n"
+"The `-ot <file>' option writes machine readable statistics to <file>.\n"
+"Each line is a JSON object; its \"type\" field tells the record type.\n"
+"Records of type \"iter\" are written after every N-th iteration, where N\n"
+"is the value of the keyword \"TelemetrySample\" (default: 1). Fields are\n"
+"    iter         number of iterations (facets added) so far\n"
+"    time         elapsed wall clock time in seconds\n"
+"    sampled      iterations since the previous record\n"
+"    facets       number of facets of the approximation\n"
+"    pos,neg,zero vertices on the positive, negative side and on the\n"
+"                 last facet added\n"
+"    new          vertices created in the last iteration\n"
+"    tests        vertex pairs to be tested in the last iteration\n"
+"    oracle_calls total number of LP calls\n"
+"    oracle_iter  total number of simplex iterations\n"
+"    memory       memory allocated in bytes\n"
+"    pool         number of facets in the facet pool\n"
+"    t_<phase>    seconds spent in <phase> since the previous record;\n"
+"                 phases are oracle, probe, classify, search, update,\n"
+"                 recalc, checkpoint, edges, barrier\n"
+"    f_pairs      total number of vertex pairs tested\n"
+"    f_few_common pairs rejected as they have less than d-1 common facets\n"
+"    f_scans      pairs reaching the full scan of common facets\n"
+"    f_scan_reject  pairs rejected by the full scan\n"
+"    f_edges      edges found\n"
+"    f_new        new vertices created\n"
+"    wait         total time all threads waited at the joining barrier\n"
+"Records of type \"mem\" are written whenever a memory slot grows or\n"
+"shrinks. Fields are\n"
+"    iter, time   iteration number and elapsed time\n"
+"    slot, title  slot number and name, see MemoryReport\n"
+"    kind         \"main\" for permanent, \"temp\" for temporary slots\n"
+"    old, new     allocated size in bytes before and after\n"
+"    blocks, blocksize  the new block structure\n"
+"    moved        bytes moved when block size changed\n"
+"    elapsed      time of reallocation and moving in seconds\n"
+"Records are buffered; the file is complete only after the program\n"
+"terminates.\n"
+"\n"
+"The `-oe <file>' option records the start and duration of each phase\n"
+"in each thread, and writes them to <file> in the Chrome trace-event\n"
+"format when the program terminates, or when a " mkstringof(DUMP_SIGNAL) " signal is\n"
+"received. The file can be opened by chrome://tracing or Perfetto. The\n"
+"phase \"edges\" is the edge search done by a single thread; \"barrier\" is\n"
+"the time a thread waits for the others to finish. At most four million\n"
+"events are kept for each thread.\n"
+"\n"
+"The `-os <file>' option maps <file> into the memory, and the program\n"
+"updates the statistics in it after each iteration at negligible cost.\n"
+"The layout is defined in livestat.h. The companion program maxe-stat\n"
+"displays the statistics of one or more running jobs.\n"
+"\n"
+"Setting the keyword \"PerfCounters\" to 1 counts CPU cycles, instructions,\n"
+"last level cache misses, data TLB misses and branch misses in the phases\n"
+"oracle, probe, classify, search and edges using the perf_event_open()\n"
+"system call of Linux. Only user space events are counted; totals over\n"
+"all threads are printed with the statistics. Values are scaled when the\n"
+"kernel shares the counters with other processes. Counters can be\n"
+"unavailable on virtual machines, or when they are restricted by\n"
+"/proc/sys/kernel/perf_event_paranoid.\n"
+);}
+
+static void benchmark_help(void) {printf(
+"******************************\n"
+"***     Benchmark modes    ***\n"
+"******************************\n"
+"\n"
+"The option `--replay=<file>' adds the facets in <file> one by one to the\n"
+"approximation using the double description method only; the oracle and\n"
+"the LP solver are not used at all. Facets are taken from lines starting\n"
+"with upper case F, in the same format as in the output, thus the result,\n"
+"checkpoint or snapshot file of a previous run of the same <vlp file> can\n"
+"be used. The initial coordinate and ideal facets are skipped. Only the\n"
+"size and direction of the problem are read from the <vlp file>. At the\n"
+"end the number of facets per second and the time spent in each phase is\n"
+"reported; no result is saved. The options -ot, -oe and -os can be used.\n"
+"\n"
+"The option `-oq <file>' records every question asked from the oracle and\n"
+"the answer it gave. Each question is a line starting with upper case Q\n"
+"followed by the d+1 coordinates of the vertex; the answer is a line\n"
+"starting with upper case A followed by the outcome (0: facet, 1: final\n"
+"vertex, 4: failure) and the d+1 coefficients of the facet (zeros if no\n"
+"facet was returned). Values are written with full precision.\n"
+"\n"
+"The option `--oracle-bench=<file>' asks the questions recorded in <file>\n"
+"in the same order from the oracle for the same <vlp file>, and compares\n"
+"the answers to the recorded ones. It reports the call latency and\n"
+"simplex iteration percentiles, and the number of answers which agree.\n"
+"Use it to compare oracle keywords such as OracleMethod, OraclePricing,\n"
+"OracleRatioTest or OracleScale on a realistic workload. Setting\n"
+"OracleEngine=1 checks the answers of the native LP engine against the\n"
+"recorded glpk answers.\n"
+"\n"
+"The option `--oracle-cache=<file>' keeps the answers of the oracle in\n"
+"<file>. Questions are identified by the content of the <vlp file> and\n"
+"the vertex coordinates rounded to 1e-9; an answer found in the cache is\n"
+"used without calling the LP solver. Thus a run repeated with different\n"
+"DD settings, or several runs on the same problem at the same time, share\n"
+"the LP work. A new file has OracleCacheSize thousand entries; the file\n"
+"is sparse and grows as entries are filled. Delete the file to empty it.\n"
+"Answers from the cache are not counted in the LP statistics.\n"
+);}
+
+static void symmetry_help(void) {printf(
+"****************************\n"
+"***      Symmetries      ***\n"
+"****************************\n"
+"The solution of many problems is invariant under some permutations of\n"
+"the objectives, for example when the random variables of a maximum\n"
+"entropy problem can be permuted. Such a group is given by generators.\n"
+"A generator is a permutation p1 p2 ... pd of 1..d, where d is the number\n"
+"of objectives; it moves objective i to objective p_i. Generators are\n"
+"read from the comment lines of the <vlp file> of the form\n"
+"   c symmetry p1 p2 ... pd\n"
+"or, when the option `--symmetry=<file>' is given, from the lines\n"
+"   G p1 p2 ... pd\n"
+"of <file>; other lines are ignored. When the oracle returns a facet,\n"
+"all of its images under the group are added to the approximation\n"
+"without asking the oracle. When a vertex is found to be final, all of\n"
+"its images are marked final when they show up. The generators are not\n"
+"checked against the problem: a wrong permutation gives a wrong result.\n"
+"Setting Symmetry=0 ignores the generators.\n"
+);}
+
+static void sweep_help(void) {printf(
+"****************************\n"
+"***    Parametric sweep  ***\n"
+"****************************\n"
+"The option `--sweep=<file>' solves the <vlp file> first, then the\n"
+"variants of it listed in <file>. A variant is a group of vlp lines\n"
+"   i <row> ...   j <col> ...   x <obj> <value>\n"
+"closed by an `e' line; `c' lines are comments. The lines change the\n"
+"row and column bounds and the internal point of the previous variant\n"
+"in place; the constraint matrix and the objectives stay the same. The\n"
+"facets of the previous variant are moved so that they support the new\n"
+"polytope, those which are not valid any more are dropped, and the rest\n"
+"is added before the oracle is asked. The LP starts from the previous\n"
+"basis. Results of the variants are appended to the output files after\n"
+"the line `C sweep variant <n>'. The sweep stops at the first variant\n"
+"which does not finish normally. The options --boot, --resume and\n"
+"--oracle-cache cannot be used together with --sweep.\n"
+);}
+
+static void exchange_help(void) {printf(
+"****************************\n"
+"***    Facet exchange    ***\n"
+"****************************\n"
+"Several processes, possibly on different machines, can solve the same\n"
+"problem together. Start each of them with the option `--exchange=<dir>'\n"
+"where <dir> is a directory they all can write, and with TrueRandom=1 so\n"
+"that they ask different questions from the oracle. Each process writes\n"
+"the facets found by its oracle to the file <host>-<pid>.fct in <dir>,\n"
+"and every ExchangeDelay seconds reads the new facets written by the\n"
+"others. These facets are added to the approximation as boot facets\n"
+"without asking the oracle; facets seen earlier are dropped. Files made\n"
+"for a different <vlp file> are ignored. The files are not deleted at\n"
+"the end; a later run can use them with the same <dir>. The option\n"
+"--sweep cannot be used together with --exchange.\n"
+);}
+
+static void control_help(void) {printf(
+"****************************\n"
+"***    Control channel   ***\n"
+"****************************\n"
+"The option `--control=<fifo>' creates the named pipe <fifo> (if it does\n"
+"not exist) and reads commands from it while the algorithm runs. Commands\n"
+"are lines written to the pipe, for example by\n"
+"   echo \"FacetPoolSize=100\" > <fifo>\n"
+"and are executed between two iterations. Commands are:\n"
+"   KEYWORD=value  change the value of one of the keywords Threads,\n"
+"                  Workers, FacetPoolSize, OracleCallLimit, ProgressReport,\n"
+"                  RecalculateVertices, CheckConsistency, CheckPoint,\n"
+"                  TimeLimit, MemoryLimit, ScoreSample\n"
+"   checkpoint     create a checkpoint file now; without the option -oc\n"
+"                  the vertices and facets are dumped as for signal " mkstringof(DUMP_SIGNAL) "\n"
+"   stop           stop as if signal " mkstringof(BREAK_SIGNAL) " was received\n"
+"   show           report the parameters which differ from the defaults\n"
+"Each command is acknowledged by a line starting with `I' on the output.\n"
+);}
+
 #include "glpk.h"
 
 static void version(void) {printf(
@@ -559,18 +833,24 @@ static struct char_params {
   CFG(VertexReport,1),
   CFG(FacetReport,1),
   CFG(MemoryReport,2),
+  CFG(PerfCounters,1),
   CFG(PrintVertices,2),
   CFG(PrintFacets,2),
   CFG(SaveVertices,2),
   CFG(SaveFacets,2),
   CFG(RandomVertex,1),
   CFG(ExactVertex,1),
+  CFG(VertexBoxes,1),
+  CFG(SealVertices,1),
   CFG(ExtractAfterBreak,1),
+  CFG(Symmetry,1),
+  CFG(AutoTune,1),
   CFG(TrueRandom,1),
   CFG(ShuffleMatrix,1),
   CFG(RoundFacets,1),
   CFG(OracleMessage,3),
   CFG(OracleScale,1),
+  CFG(OracleEngine,2),
   CFG(OracleMethod,1),
   CFG(OracleRatioTest,1),
   CFG(OraclePricing,1),
@@ -596,9 +876,14 @@ static struct int_params {
   CFG(TimeLimit,60,10000000),
   CFG(CheckPoint,500,1000000),
   CFG(Threads,0,MAX_THREADS),
+  CFG(Workers,0,MAX_WORKERS),
   CFG(OracleCallLimit,0,MAX_OCALL_LIMIT),
   CFG(OracleItLimit,10,10000000),
   CFG(OracleTimeLimit,1,1000000),
+  CFG(TelemetrySample,1,1000000),
+  CFG(OracleCacheSize,1,1000000),
+  CFG(ExchangeDelay,1,3600),
+  CFG(ScoreSample,100,10000000),
   {NULL,NULL,0,0,0,0}
 };
 
@@ -661,6 +946,42 @@ static int treat_keyword(const char *line)
  return 0; // not found
 }
 
+/***********************************************************************
+* int change_parameter(const char *line)
+*    set a keyword from runtime_keywords[] to the given value. The value
+*    is checked as at startup; 'zero' tells whether 0 is a legal value
+*    (such as "no limit"), otherwise it must be in the [min,max] range.
+*/
+static const struct {
+    const char *name;	// keyword
+    int        zero;	// 0 is accepted
+} runtime_keywords[]={
+#ifdef USETHREADS
+  {"Threads",1},
+#endif
+  {"Workers",1},	{"FacetPoolSize",1},	{"OracleCallLimit",1},
+  {"ProgressReport",1},	{"RecalculateVertices",1}, {"CheckConsistency",1},
+  {"CheckPoint",0},	{"TimeLimit",1},	{"MemoryLimit",1},
+  {"ScoreSample",1},	{NULL,0} };
+
+int change_parameter(const char *line)
+{struct int_params *p; int val,i; size_t len; char c;
+    for(p=&INT_PARAMS[0];p->format;p++){
+        if(sscanf(line,p->format,&val,&c)!=1) continue;
+        for(i=0;runtime_keywords[i].name;i++){
+            len=strlen(runtime_keywords[i].name);
+            if(strncmp(p->format+1,runtime_keywords[i].name,len)==0 && p->format[len+1]==' ')
+                break;
+        }
+        if(!runtime_keywords[i].name) return 0; // cannot be changed
+        if(val==0 && !runtime_keywords[i].zero) return -1;
+        if(val!=0 && (val<p->min || val > p->max)) return -1;
+        *(p->ptr)=val;
+        return 1;
+    }
+    return 0; // not found
+}
+
 /** set_default_values(): set default values for unset PARAMS **/
 static void set_default_values(void)
 {{struct char_params *p; // character/bool params
@@ -794,6 +1115,12 @@ static int handle_options(int argc, const char *argv[])
     if(strcmp (argv[1],"--help=boot")==0){ boot_help(); return 1; }
     if(strncmp(argv[1],"--help=resume",11)==0){ resume_help(); return 1; }
     if(strncmp(argv[1],"--help=config",11)==0){ dump_config(); return 1; }
+    if(strncmp(argv[1],"--help=tele",11)==0){ telemetry_help(); return 1; }
+    if(strncmp(argv[1],"--help=bench",12)==0){ benchmark_help(); return 1; }
+    if(strncmp(argv[1],"--help=sym",10)==0){ symmetry_help(); return 1; }
+    if(strncmp(argv[1],"--help=sweep",12)==0){ sweep_help(); return 1; }
+    if(strncmp(argv[1],"--help=exch",11)==0){ exchange_help(); return 1; }
+    if(strncmp(argv[1],"--help=contr",12)==0){ control_help(); return 1; }
     if(strcmp (argv[1],"--help")==0){ long_help(); return 1; }
     if(strcmp (argv[1],"-h")==0 || strcmp(argv[1],"-help")==0){ 
         short_help(); return 1; }
@@ -812,6 +1139,20 @@ static int handle_options(int argc, const char *argv[])
             PARAMS(BootFile)=argv[c]+7;
         } else if(strncmp(argv[c],"--resume=",9)==0){
             PARAMS(ResumeFile)=argv[c]+9;
+        } else if(strncmp(argv[c],"--replay=",9)==0){
+            PARAMS(ReplayFile)=argv[c]+9;
+        } else if(strncmp(argv[c],"--oracle-bench=",15)==0){
+            PARAMS(OracleBenchFile)=argv[c]+15;
+        } else if(strncmp(argv[c],"--oracle-cache=",15)==0){
+            PARAMS(OracleCacheFile)=argv[c]+15;
+        } else if(strncmp(argv[c],"--symmetry=",11)==0){
+            PARAMS(SymmetryFile)=argv[c]+11;
+        } else if(strncmp(argv[c],"--sweep=",8)==0){
+            PARAMS(SweepFile)=argv[c]+8;
+        } else if(strncmp(argv[c],"--exchange=",11)==0){
+            PARAMS(ExchangeDir)=argv[c]+11;
+        } else if(strncmp(argv[c],"--control=",10)==0){
+            PARAMS(ControlFile)=argv[c]+10;
         } else { // --KEYWORD=value
             int r=treat_keyword(argv[c]+2);
             if(r==-1){
@@ -837,7 +1178,8 @@ static int handle_options(int argc, const char *argv[])
             break;
         case 'o': // output file
             val=argv[c][2];
-            if(val && ((val!='v' && val!='f' && val!='c') || argv[c][3])){
+            if(val && ((val!='v' && val!='f' && val!='c' && val!='t' && val!='e' && val!='s' && val!='q')
+                  || argv[c][3])){
                 report(R_fatal,"Unknown option: %s\n",argv[c]);
                 config_error++; return -1;
             }
@@ -848,6 +1190,10 @@ static int handle_options(int argc, const char *argv[])
             c++; if(val=='v') PARAMS(SaveVertexFile)=argv[c];
             else if(val=='f') PARAMS(SaveFacetFile)=argv[c];
             else if(val=='c') PARAMS(CheckPointStub)=argv[c];
+            else if(val=='t') PARAMS(TelemetryFile)=argv[c];
+            else if(val=='e') PARAMS(TraceFile)=argv[c];
+            else if(val=='s') PARAMS(StatFile)=argv[c];
+            else if(val=='q') PARAMS(QueryFile)=argv[c];
             else PARAMS(SaveFile)=argv[c];
             break;
         case 'n': // problem name
@@ -940,6 +1286,10 @@ static void postprocess_parameters(void)
     if(PARAMS(SaveFile) && !*PARAMS(SaveFile)) PARAMS(SaveFile)=0;
     if(PARAMS(SaveVertexFile) && !*PARAMS(SaveVertexFile)) PARAMS(SaveVertexFile)=0;
     if(PARAMS(SaveFacetFile) && !*PARAMS(SaveFacetFile)) PARAMS(SaveFacetFile)=0;
+    if(PARAMS(TelemetryFile) && !*PARAMS(TelemetryFile)) PARAMS(TelemetryFile)=0;
+    if(PARAMS(TraceFile) && !*PARAMS(TraceFile)) PARAMS(TraceFile)=0;
+    if(PARAMS(StatFile) && !*PARAMS(StatFile)) PARAMS(StatFile)=0;
+    if(PARAMS(QueryFile) && !*PARAMS(QueryFile)) PARAMS(QueryFile)=0;
     if(PARAMS(SaveFile)){ // -o <file>
         if(PARAMS(SaveVertexFile) && 
            strcmp(PARAMS(SaveFile),PARAMS(SaveVertexFile))==0){
@@ -960,8 +1310,34 @@ static void postprocess_parameters(void)
         report(R_fatal,"No --boot can be specified when resuming computation\n");
         config_error++;
     }
+    if(PARAMS(ReplayFile) && !*PARAMS(ReplayFile)) PARAMS(ReplayFile)=0;
+    if(PARAMS(OracleBenchFile) && !*PARAMS(OracleBenchFile)) PARAMS(OracleBenchFile)=0;
+    if(PARAMS(OracleCacheFile) && !*PARAMS(OracleCacheFile)) PARAMS(OracleCacheFile)=0;
+    if(PARAMS(SymmetryFile) && !*PARAMS(SymmetryFile)) PARAMS(SymmetryFile)=0;
+    if(PARAMS(SweepFile) && !*PARAMS(SweepFile)) PARAMS(SweepFile)=0;
+    if(PARAMS(ExchangeDir) && !*PARAMS(ExchangeDir)) PARAMS(ExchangeDir)=0;
+    if(PARAMS(ControlFile) && !*PARAMS(ControlFile)) PARAMS(ControlFile)=0;
+    if((PARAMS(ReplayFile) || PARAMS(OracleBenchFile)) && 
+       (PARAMS(ResumeFile) || PARAMS(BootFile))){
+        report(R_fatal,"No --boot or --resume can be specified in benchmark mode\n");
+        config_error++;
+    }
+    if(PARAMS(ReplayFile) && PARAMS(OracleBenchFile)){
+        report(R_fatal,"Only one of --replay and --oracle-bench can be given\n");
+        config_error++;
+    }
+    if(PARAMS(SweepFile) && (PARAMS(ReplayFile) || PARAMS(OracleBenchFile) ||
+       PARAMS(ResumeFile) || PARAMS(BootFile) || PARAMS(OracleCacheFile))){
+        report(R_fatal,"No --boot, --resume, --oracle-cache or benchmark can be "
+               "specified with --sweep\n");
+        config_error++;
+    }
+    if(PARAMS(ExchangeDir) && PARAMS(SweepFile)){
+        report(R_fatal,"No --exchange can be specified with --sweep\n");
+        config_error++;
+    }
     // do we have any output?
-    if(!PARAMS(VertexReport) && !PARAMS(PrintVertices)
+    if(!PARAMS(ReplayFile) && !PARAMS(OracleBenchFile) && !PARAMS(VertexReport) && !PARAMS(PrintVertices)
        && !PARAMS(SaveVertices) && !PARAMS(SaveVertexFile)
        && !PARAMS(SaveFacets) && !PARAMS(SaveFacetFile)){
         report(R_fatal,"No output is specified; all computation would be lost...\n");
@@ -1018,10 +1394,13 @@ void show_parameters(char *hdr)
     CFG(OracleItLimit);
     CFG(OracleTimeLimit);
     CFG(OracleScale);		/* scale the constraint matrix */
+    CFG(OracleEngine);		/* glpk / native LP engine */
     CFG(ShuffleMatrix);		/* random shuffle of the constraint matrix */
     CFG(RoundFacets);		/* round vertices reported by the oracle */
     CFG(RandomVertex);		/* pick next facet randomly */
     CFG(ExactVertex);		/* recompute vertex coords immediately */
+    CFG(VertexBoxes);		/* bounding boxes of vertex groups */
+    CFG(SealVertices);		/* leave out sealed final vertices */
 //    CFG(MemoryLimit);		/* memory limit in Mbytes */
 //    CFG(TimeLimit);		/* time limit in seconds */
     CFG(FacetPoolSize);		/* use facet pool */
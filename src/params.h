@@ -28,18 +28,24 @@ struct params_t {
     VertexReport,	/* print out vertices when they are found */
     FacetReport,	/* print out final facets when found */
     MemoryReport,	/* print combinatorial memory usage  whenever changes */
+    PerfCounters,	/* sample hardware counters in hot phases */
     PrintVertices,	/* dump vertices at the end */
     PrintFacets,	/* dump facets at the end */
     SaveVertices,	/* save vertices at the end */
     SaveFacets,		/* save facets at the end */
     RandomVertex,	/* pick the vertex to be tested randomly */
     ExactVertex,	/* always calculate vertex coords from adjacent facets */
+    VertexBoxes,	/* classify groups of vertices by bounding boxes */
+    SealVertices,	/* skip final vertices with final neighbours only */
     ExtractAfterBreak,	/* continue after break with extracting vertices */
+    Symmetry,		/* use the declared symmetries of the objectives */
+    AutoTune,		/* adjust facet pool size and oracle call limit */
     ShuffleMatrix,	/* (oracle) shuffle rows, columns, and objective order.
 			   helps numerical stability */
     RoundFacets,	/* (oracle) round vertex coordinates to the nearest rational */
     OracleMessage,	/* 0: quiet, 1: error, 2: on, 3: verbose */
     OracleScale,	/* scale constraint matrix;  0: no, 1: yes */
+    OracleEngine,	/* 0: glpk, 1: native, 2: both and compare */
     OracleMethod,	/* 0: primal, 1: dual */
     OracleRatioTest,	/* 0: standard, 1: Harris */
     OraclePricing,	/* 0: standard, 1: steepest edge */
@@ -59,9 +65,14 @@ struct params_t {
     MemoryLimit,	/* stop when reaching that mamory usage, in Mbytes */
     TimeLimit,		/* stop when running for that many seconds */
     Threads,		/* number of threads to use, only when USETHREADS defined */
+    Workers,		/* number of worker processes searching edges */
     OracleItLimit,	/* iteration limit, >=1000; =0: unlimited */
     OracleTimeLimit,	/* time limit in seconds, >=5; =0: unlimited */
     OracleCallLimit,	/* limit of oracle calls in each iteration */
+    TelemetrySample,	/* write telemetry record after that many iterations */
+    OracleCacheSize,	/* entries in a new oracle cache file, in thousands */
+    ExchangeDelay,	/* seconds between two facet exchanges */
+    ScoreSample,	/* vertices sampled when scoring the pool, 0: exact */
     ProblemColumns,	/* problem columns, set by the Oracle */
     ProblemRows,	/* problem rows, set by the Oracle */
     ProblemObjects,	/* problem objects (dimension), set by the Oracle */
@@ -81,12 +92,23 @@ struct params_t {
     *VlpFile,		/* the input vlp file */
     *BootFile,		/* initial list of vertices */
     *ResumeFile,	/* resume from this checkpoint file */
+    *ReplayFile,	/* replay facets from this file */
+    *OracleBenchFile,	/* replay oracle queries from this file */
+    *OracleCacheFile,	/* --oracle-cache=<file> option */
+    *SymmetryFile,	/* --symmetry=<file> option */
+    *SweepFile,		/* --sweep=<file> option */
+    *ExchangeDir,	/* --exchange=<dir> option */
+    *ControlFile,	/* --control=<fifo> option */
     *ProblemName,	/* the problem name, typically the base of the vlp file */
     *ConfigFile,	/* configuration file name */
     *CheckPointStub,	/* -oc <stub> option */
     *SaveFile,		/* -o <file> option */
     *SaveVertexFile,	/* -ov <file> option */
-    *SaveFacetFile;	/* -of <file> option */
+    *SaveFacetFile,	/* -of <file> option */
+    *TelemetryFile,	/* -ot <file> option */
+    *TraceFile,		/* -oe <file> option */
+    *StatFile,		/* -os <file> option */
+    *QueryFile;		/* -oq <file> option */
 };
 
 extern struct params_t GlobalParams;
@@ -108,10 +130,20 @@ extern struct params_t GlobalParams;
 * void show_parameters(char *hdr)
 *    print algorithm and oracle parameters which differ from their
 *    default values. Put hdr before the first line.
+*
+* int change_parameter(const char *line)
+*    set an integer keyword while the algorithm runs; 'line' is
+*    KEYWORD=value. Only the keywords which can be changed between
+*    iterations are accepted, and the value is checked as at startup.
+*    Return value:
+*      1:  the value has been changed
+*      0:  unknown keyword, or it cannot be changed
+*     -1:  value is out of range, or it is 0 which is not allowed
 */
 
 int process_parameters(int argc, const char *argv[]);
 void show_parameters(char *hdr);
+int change_parameter(const char *line);
 
 /***********************************************************************
 * mkstringof() macro
@@ -142,6 +174,9 @@ void show_parameters(char *hdr);
  #define MAX_THREADS	1	/* no threads */
 #endif
 
+#ifndef MAX_WORKERS
+#define MAX_WORKERS	64	/* number of worker processes allowed */
+#endif
 #ifndef MAX_FACET_POOL
 #define MAX_FACET_POOL	3000	/* maximum size of the facet pool */
 #endif
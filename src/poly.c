@@ -35,6 +35,7 @@
 #include "report.h"
 #include "poly.h"
 #include "params.h"
+#include "telemetry.h"
 
 #ifdef USETHREADS
 /************************************************************************
@@ -145,7 +146,9 @@ static void thread_execute(ThreadJob_t job)
     ThreadJob=job;
     pthread_barrier_wait(&ThreadBarrierForking); // start threads
       job(0); // main thread
+    phase_begin(0,PH_barrier);
     pthread_barrier_wait(&ThreadBarrierJoining); // wait until others finish
+    phase_end(0,PH_barrier);
 }
 
 /* void *extra_thread(void *arg)
@@ -158,7 +161,9 @@ int myId=data->id;
        pthread_barrier_wait(&ThreadBarrierForking);
        if(data->quit) break; // stop
        ThreadJob(myId);
+       phase_begin(myId,PH_barrier);
        pthread_barrier_wait(&ThreadBarrierJoining);
+       phase_end(myId,PH_barrier);
     }
     report(R_info,"Thread %d stopped\n",myId);
     return NULL;
@@ -177,6 +182,8 @@ int i;
     for(i=1;i<PARAMS(Threads);i++){
         pthread_join(ThreadData[i].obj,NULL);
     }
+    pthread_barrier_destroy(&ThreadBarrierForking);
+    pthread_barrier_destroy(&ThreadBarrierJoining);
 }
 #else /* ! USETHREADS */
 #define ThreadNo		1 /* number of threads */
@@ -236,10 +243,16 @@ M_VertexAdjStore,		/* adjacency list of vertices */
 M_FacetAdjStore,		/* adjacency list of facets */
 M_VertexLiving,			/* single vertex bitmap of actual vertices */
 M_VertexFinal,			/* single vertex bitmap of final vertices, subset of VertexLiving */
+M_VertexSealed,			/* single vertex bitmap of sealed vertices, subset of VertexFinal */
+M_VertexNewFinal,		/* single vertex bitmap of vertices marked final recently */
+M_VertexBoxStore,		/* bounding boxes of the vertex hierarchy */
+M_VertexBoxIndex,		/* vertices in the order of the hierarchy */
+M_VertexBoxPos,			/* position of vertices in VertexBoxIndex */
 M_MAINSLOTS,			/* last main slot index */
 		/* temporary slots - global for all threads */
 M_VertexDistStore=M_MAINSLOTS,	/* vertex distances from the new facet */
 M_VertexPosnegList,		/* indices of vertices on positive/negative side */
+M_VertexSealWork,		/* candidate neighbours when sealing vertices */
 		/* private slots for threads */
 M_THREAD_SLOTS,
 M_FacetList=M_THREAD_SLOTS,	/* facets adjacent to two vertices */
@@ -270,8 +283,14 @@ M_MSLOTSTOTAL			/* total number of managed memory */
 #define TM_FacetAdjStore	"FacetAdj"
 #define TM_VertexLiving		"VertexLiving"
 #define TM_VertexFinal		"VertexFinal"
+#define TM_VertexSealed		"VertexSealed"
+#define TM_VertexNewFinal	"VertexNewFinal"
+#define TM_VertexBoxStore	"VertexBox"
+#define TM_VertexBoxIndex	"VertexBoxIndex"
+#define TM_VertexBoxPos		"VertexBoxPos"
 #define TM_VertexDistStore	"VertexDist"
 #define TM_VertexPosnegList	"VertexPosNeg"
+#define TM_VertexSealWork	"VertexSealWork"
 #define TM_FacetList		"FacetList"
 #define TM_VertexWork		"VertexWork"
 #define TM_FacetArray		"FacetArray"
@@ -427,17 +446,23 @@ static inline void AUX_request_main_mem(memslot_t slot, size_t nno, size_t nsize
 /* int reallocmem(void)
 *    allocate previously requested memory; if successful, adjust
 *    blocks to the given count and size, and clear the new part.
-*    Return 1 if out of memory, otherwise return 0. */
+*    Return 1 if out of memory, otherwise return 0. Each slot change
+*    is sent to telemetry_memory() with the bytes moved by restriding
+*    the blocks and the time spent. */
 static int reallocmem(void)
 {MEMSLOT *ms; int j,success; size_t total; void *ptr;
+ size_t oldsize[M_MAINSLOTS]; double elapsed[M_MAINSLOTS],start;
     for(j=0,success=1,ms=&memory_slots[0];
         success && j<M_MAINSLOTS; j++,ms++
     ){
+        oldsize[j]=ms->rsize; elapsed[j]=0.0;
         if(ms->newblocksize){
             total=ms->newblocksize*ms->newblockno;
             if(ms->rsize<total){
                 dd_stats.memory_allocated_no++;
+                start=phase_clock();
                 ptr=realloc(ms->ptr,total);
+                elapsed[j]=phase_clock()-start;
                 if(ptr){
                     ms->ptr=ptr; 
                     dd_stats.total_memory += total-ms->rsize;
@@ -453,6 +478,8 @@ static int reallocmem(void)
     // adjust block structure
     for(j=0,ms=&memory_slots[0]; j<M_MAINSLOTS; j++,ms++){
         if(ms->newblocksize){
+            size_t moved=0;
+            start=phase_clock();
             if(ms->blocksize < ms->newblocksize){ // block size grow
                 size_t i,n; char *bo,*bn; // pointer to old and new
                 n=ms->newblockno; if(ms->blockno<n) n=ms->blockno;
@@ -460,7 +487,7 @@ static int reallocmem(void)
                 bn=((char*)ms->ptr)+(n*ms->newblocksize);
                 for(i=n;i>0;i--){
                     bo -= ms->blocksize; bn -= ms->newblocksize;
-                    if(i>1) memmove(bn,bo,ms->blocksize);
+                    if(i>1){ memmove(bn,bo,ms->blocksize); moved += ms->blocksize; }
                     // clear the rest
                     memset(bn+ms->blocksize,0,ms->newblocksize-ms->blocksize);
                 }
@@ -469,7 +496,7 @@ static int reallocmem(void)
                 n=ms->newblockno; if(ms->blockno<n)n=ms->blockno;
                 bo=(char*)ms->ptr; bn=(char*)ms->ptr;
                 for(i=0;i<n;i++){
-                    if(i) memmove(bn,bo,ms->newblocksize);
+                    if(i){ memmove(bn,bo,ms->newblocksize); moved += ms->newblocksize; }
                     bo += ms->blocksize;
                     bn += ms->newblocksize;
                 }
@@ -492,6 +519,9 @@ static int reallocmem(void)
                     ms->rsize=total+DD_LOWWATER;
                 }
             }
+            elapsed[j] += phase_clock()-start;
+            telemetry_memory(j,ms->title,"main",oldsize[j],ms->rsize,
+                ms->blockno,ms->blocksize,moved,elapsed[j]);
         }
     }
     return 0;
@@ -536,7 +566,7 @@ inline static void yfree(memslot_t slot)
 */
 static void AUX_init_temp_slot(memslot_t slot, size_t nno, size_t n, size_t bsize,
                            const char *title, const char *type)
-{size_t total,nsize; MEMSLOT *ms;
+{size_t total,nsize,oldsize; MEMSLOT *ms; double start;
     if(OUT_OF_MEMORY) return;
     ms=&memory_slots[slot];
     nsize=n*bsize;
@@ -546,6 +576,7 @@ static void AUX_init_temp_slot(memslot_t slot, size_t nno, size_t n, size_t bsiz
     ms->title=title; ms->type=type;
     total=nno*nsize;
     if(total <= ms->rsize) return;
+    start=phase_clock(); oldsize=ms->rsize;
     if(ms->ptr){ 
         free(ms->ptr);
         dd_stats.total_memory -= ms->rsize;
@@ -560,7 +591,10 @@ static void AUX_init_temp_slot(memslot_t slot, size_t nno, size_t n, size_t bsiz
         report(R_fatal,"Out of memory for slot=%d (%s), blocksize=%zu, n=%zu\n",
             slot,title,nsize,nno);
         OUT_OF_MEMORY=1;
+        return;
     }
+    telemetry_memory(slot,title,"temp",oldsize,total,nno,nsize,0,
+        phase_clock()-start);
 }
 
 /* void trequest(slot,threadID,n)
@@ -575,14 +609,17 @@ static void AUX_init_temp_slot(memslot_t slot, size_t nno, size_t n, size_t bsiz
 *       nno:   number of blocks required
 */
 static inline void AUX_request_temp_mem(memslot_t slot,size_t nno)
-{size_t total; MEMSLOT *ms; void *ptr;
+{size_t total; MEMSLOT *ms; void *ptr; double start;
     if(OUT_OF_MEMORY) return;
     ms=&memory_slots[slot];
     total = ms->blocksize*nno;
     if(total<=ms->rsize) return;
     dd_stats.memory_allocated_no++;
+    start=phase_clock();
     ptr=realloc(ms->ptr,total);
     if(!ptr){ OUT_OF_MEMORY=1; return; }
+    telemetry_memory(slot,ms->title,"temp",ms->rsize,total,nno,ms->blocksize,
+        0,phase_clock()-start);
     dd_stats.total_memory += total - ms->rsize;
     if(dd_stats.total_memory>dd_stats.max_memory)
           dd_stats.max_memory=dd_stats.total_memory;
@@ -697,6 +734,30 @@ static int get_bitcount(BITMAP_t v)
 
 DD_STATS dd_stats;
 
+/* edge_funnel_t EdgeFunnel[MAX_THREADS]
+*    counters of the edge tests of each thread; padded to avoid false
+*    sharing between threads */
+typedef struct {
+    EDGE_FUNNEL f;		/* the counters */
+    char pad[64];		/* avoid false sharing */
+} edge_funnel_t;
+
+static edge_funnel_t EdgeFunnel[MAX_THREADS];
+
+void get_edge_funnel(int threadId, EDGE_FUNNEL *f)
+{int i;
+    if(threadId>=0){ *f=EdgeFunnel[threadId].f; return; }
+    memset(f,0,sizeof(EDGE_FUNNEL));
+    for(i=0;i<MAX_THREADS;i++){
+        f->pairs        += EdgeFunnel[i].f.pairs;
+        f->few_common   += EdgeFunnel[i].f.few_common;
+        f->scans        += EdgeFunnel[i].f.scans;
+        f->scan_reject  += EdgeFunnel[i].f.scan_reject;
+        f->edges        += EdgeFunnel[i].f.edges;
+        f->new_vertices += EdgeFunnel[i].f.new_vertices;
+    }
+}
+
 /*************************************************************************
 *
 *    V E R T I C E S    A N D    F A C E T S
@@ -715,11 +776,13 @@ DD_STATS dd_stats;
 * double *FacetCoords(fno), BITMAP_t *FacetAdj(fno)
 *   the memory block and adjacency block of a vertex and a facet
 *
-* BITMAP_t *VertexLiving, *VertexFinal
-*   bitmaps marking valid and final vertices
+* BITMAP_t *VertexLiving, *VertexFinal, *VertexSealed, *VertexNewFinal
+*   bitmaps marking valid, final, and sealed vertices; vertices marked
+*   final since the last iteration
 *
 * double VertexDist[0 .. MaxVertices]
-*   distance of vertices from the next facet
+*   distance of vertices from the next facet; DIST_UNKNOWN if the vertex
+*   is positive by its box and the distance was not computed
 *
 * int *VertexPosnegList
 *   vertices on the positive and negative side of the new facet
@@ -759,14 +822,21 @@ static int
     get_memory_ptr(BITMAP_t,M_VertexLiving)
 #define VertexFinal		\
     get_memory_ptr(BITMAP_t,M_VertexFinal)
-/* double VertexDist(vno); int *VertexPosNegList */
+#define VertexSealed		\
+    get_memory_ptr(BITMAP_t,M_VertexSealed)
+#define VertexNewFinal		\
+    get_memory_ptr(BITMAP_t,M_VertexNewFinal)
+/* double VertexDist(vno); int *VertexPosNegList
+*  DIST_UNKNOWN marks a positive vertex whose distance was not computed;
+*  a computed distance of a positive vertex exceeds PolytopeEps */
+#define DIST_UNKNOWN	(-1.0)
 #define VertexDist(vno)		\
     get_memory_ptr(double,M_VertexDistStore)[vno]
 #define VertexPosnegList	\
     get_memory_ptr(int,M_VertexPosnegList)
  
 /* void get_dd_vertexno(void)
-*    compute the number of living and final vertices into dd_stats
+*    compute the number of living, final and sealed vertices into dd_stats
 *  int get_vertexnum()
 *    number of living vertices
 *  int get facetnum()
@@ -774,11 +844,13 @@ static int
 void get_dd_vertexno(void)
 {int i,vno; BITMAP_t vl,vf;
     dd_stats.living_vertex_no=0; dd_stats.final_vertex_no=0;
+    dd_stats.sealed_vertex_no=0;
     for(i=0;i<VertexBitmapBlockSize;i++){
         vl=VertexLiving[i];
         dd_stats.living_vertex_no += get_bitcount(vl);
         vf=VertexFinal[i];
         dd_stats.final_vertex_no += get_bitcount(vf);
+        dd_stats.sealed_vertex_no += get_bitcount(VertexSealed[i]);
         if(~vl & vf){ // consistency checking
             vno=i<<packshift;
             while(!((~vl&vf)&1)){ vno++;vl>>=1;vf>>=1;}
@@ -847,17 +919,25 @@ static int
 * BOOL is_finalVertex(vno)
 *     check if bit 'vno' is set in bitmap VertexFinal
 * void set_in_VertexFinal(vno)
-*     set bit 'vno' in bitmap VertexFinal */
+*     set bit 'vno' in bitmap VertexFinal
+* BOOL is_sealedVertex(vno)
+*     check if bit 'vno' is set in bitmap VertexSealed
+* void set_in_VertexSealed(vno)
+*     set bit 'vno' in bitmap VertexSealed */
 
 #define is_livingVertex(vno)	    extract_bit(VertexLiving,vno)
 #define set_in_VertexLiving(vno)    set_bit(VertexLiving,vno)
 #define is_finalVertex(vno)	    extract_bit(VertexFinal,vno)
 #define set_in_VertexFinal(vno)     set_bit(VertexFinal,vno)
+#define is_sealedVertex(vno)	    extract_bit(VertexSealed,vno)
+#define set_in_VertexSealed(vno)    set_bit(VertexSealed,vno)
 
 /* void mark_vertex_as_final(vno)
-*     exported version of set_in_VertexLiving(vno)
-*  void intersect_FacetAdj_VertexLiving(fno)
-*     clear bits in the adjacency list of 'fno' which are not living
+*     exported version of set_in_VertexFinal(vno), also records the
+*     vertex in VertexNewFinal
+*  void clear_vertex_in_FacetAdj(vno)
+*     clear bit 'vno' in the adjacency list of the facets 'vno' is
+*     adjacent to; call it when 'vno' is deleted
 *  void move_vertex_to(coords,adj)bitmap,vno)
 *     move vertex with coordinates and adjacency list to the given index
 *  void clear_VertexAdj(vno)
@@ -871,12 +951,19 @@ static int
 *      NewVertexAdj to the index 'vno' */
 
 void mark_vertex_as_final(int vno)
-{   set_bit(VertexFinal,vno); }
+{   set_bit(VertexFinal,vno); set_bit(VertexNewFinal,vno); }
 
-inline static void intersect_FacetAdj_VertexLiving(int fno)
-{int i;
-    for(i=0;i<VertexBitmapBlockSize;i++)
-        FacetAdj(fno)[i] &= VertexLiving[i];
+inline static void clear_vertex_in_FacetAdj(int vno)
+{int fno,i,j; BITMAP_t fc;
+    fno=0;for(i=0;i<FacetBitmapBlockSize;i++){
+        j=fno; fc=VertexAdj(vno)[i];
+        while(fc){
+            while((fc&7)==0){ j+=3; fc>>=3; }
+            if(fc&1) clear_bit(FacetAdj(j),vno);
+            j++; fc>>=1;
+        }
+        fno += (1<<packshift);
+    }
 }
 inline static void move_vertex_to(double *coords,BITMAP_t *adj,int vno)
 {   memcpy(VertexCoords(vno),coords,VertexSize*sizeof(double));
@@ -895,6 +982,243 @@ inline static void move_NewVertex_th(int thId,int vno)
 {   move_vertex_to(NewVertexCoords(thId,NewVertex[thId]),
                    NewVertexAdj(thId,NewVertex[thId]),vno); }
 
+/***********************************************************************
+* Vertex boxes
+*
+* Living vertices are kept in a bounding volume hierarchy. When it is
+* built, the living vertices are listed in VertexBoxIndex[], and this
+* list is split recursively at the median of the widest coordinate
+* until parts have at most BOX_LEAF vertices. Node k covers the part
+* [lo,hi), its children are 2k and 2k+1 splitting it in the middle;
+* the root is node 1 covering [0,BoxVertices). VertexBox(k) is the box
+* of the coordinates in node k: the lower corner followed by the upper
+* corner. When a facet is far enough from a box, all vertices below
+* that node are on the same side, and their distances need not be
+* computed. Vertices becoming living later are appended to the list
+* after the tree; each BOX_LEAF of them form a leaf with its own box
+* VertexBox(BoxNodes+c). Deleted vertices remain in the boxes, and an
+* entry is valid only if its vertex is living and BoxPos(vno) points
+* back to it, as a vertex slot can be reused. The hierarchy is rebuilt
+* when BoxStale, the number of deleted or moved vertices, exceeds a
+* quarter of the vertices in the tree, when there is no more space
+* after the tree, or when coordinates change in place. It is used only
+* when PARAMS(VertexBoxes) is set.
+*
+* double *VertexBox(k)
+*   the box of node k, 2*VertexSize doubles
+* int *VertexBoxIndex, BoxPos(vno)
+*   list of vertices; position of a vertex in this list
+* void box_insert(vno)
+*   append vno to the list after the tree, extend the box of its leaf
+* int boxes_ready(void)
+*   return 1 if boxes should be used, rebuilding them if necessary.
+*   The boxes are optional: when there is no memory for them, their
+*   slots are released, OUT_OF_MEMORY is cleared, and BoxOff turns
+*   them off until the structures are initialized again.
+* double box_distance(double *facet, int k)
+*   a lower bound on the distance of the facet from the vertices in
+*   the box of node k, as computed by vertex_distance(). The bound is
+*   lowered by BOX_MARGIN times the magnitude of the terms, which
+*   exceeds the rounding error of both sums; thus the boxes decide a
+*   vertex only when vertex_distance() would decide it the same way.
+* int box_probe(double *facet)
+*   the number of vertices on the negative side of the facet
+* void box_positive(double *facet, BITMAP_t *positive)
+*   set the bits of vertices which are on the positive side of the
+*   facet by their boxes; other vertices must be checked one by one.
+*/
+
+#define BOX_LEAF	64	/* maximal number of vertices in a leaf */
+#define BOX_MARGIN	1e-12	/* relative safety margin of box tests */
+
+#define VertexBox(k)		\
+    (get_memory_ptr(double,M_VertexBoxStore)+((k)*2*VertexSize))
+#define VertexBoxIndex		\
+    get_memory_ptr(int,M_VertexBoxIndex)
+#define BoxPos(vno)		\
+    get_memory_ptr(int,M_VertexBoxPos)[vno]
+
+static int
+  BoxValid=0,		// the hierarchy contains all living vertices
+  BoxStale=0,		// vertices deleted or moved since the last rebuild
+  BoxVertices=0,	// number of vertices in the tree
+  BoxNodes=0,		// number of tree nodes, the first leaf after the tree
+  BoxTail=0,		// vertices appended after the tree
+  BoxTailCap=0,		// space after the tree
+  BoxOff=0;		// no memory for the boxes
+
+/* is_validBoxEntry(p)
+*    the vertex at position p of VertexBoxIndex[] is living and it has
+*    not been added later at another position */
+#define is_validBoxEntry(p)	\
+    (is_livingVertex(VertexBoxIndex[p]) && BoxPos(VertexBoxIndex[p])==(p))
+
+/* void box_set(box,v), box_add(box,v)
+*    set the box to the point v; extend the box to contain v */
+inline static void box_set(double *box, const double *v)
+{   memcpy(box,v,VertexSize*sizeof(double));
+    memcpy(box+VertexSize,v,VertexSize*sizeof(double)); }
+
+inline static void box_add(double *box, const double *v)
+{int j; double *hi=box+VertexSize;
+    for(j=0;j<=DIM;j++){
+        if(v[j]<box[j]) box[j]=v[j];
+        if(v[j]>hi[j]) hi[j]=v[j];
+    }
+}
+
+static void box_insert(int vno)
+{int p;
+    if(!PARAMS(VertexBoxes) || !BoxValid) return;
+    if(BoxTail>=BoxTailCap){ BoxValid=0; return; } // rebuild at next use
+    p=BoxVertices+BoxTail;
+    VertexBoxIndex[p]=vno; BoxPos(vno)=p;
+    if(BoxTail%BOX_LEAF==0) box_set(VertexBox(BoxNodes+BoxTail/BOX_LEAF),VertexCoords(vno));
+    else box_add(VertexBox(BoxNodes+BoxTail/BOX_LEAF),VertexCoords(vno));
+    BoxTail++;
+}
+
+/* void box_select(lo,hi,mid,c)
+*    reorder VertexBoxIndex[lo:hi-1] so that the vertex at 'mid' has
+*    the mid-th smallest c-th coordinate, smaller ones come before it
+*    and larger ones after it. */
+static void box_select(int lo, int hi, int mid, int c)
+{int i,j,t; int *idx=VertexBoxIndex; double pivot;
+    hi--;
+    while(lo<hi){
+        pivot=VertexCoords(idx[(lo+hi)/2])[c];
+        i=lo; j=hi;
+        while(i<=j){
+            while(VertexCoords(idx[i])[c]<pivot) i++;
+            while(VertexCoords(idx[j])[c]>pivot) j--;
+            if(i<=j){ t=idx[i]; idx[i]=idx[j]; idx[j]=t; i++; j--; }
+        }
+        if(mid<=j) hi=j; else if(mid>=i) lo=i; else return;
+    }
+}
+
+/* void box_build(k,lo,hi)
+*    compute the box of node k, and split it if it is not a leaf */
+static void box_build(int k, int lo, int hi)
+{int p,j,c,mid; double *box,w,wmax;
+    box=VertexBox(k);
+    box_set(box,VertexCoords(VertexBoxIndex[lo]));
+    for(p=lo+1;p<hi;p++) box_add(box,VertexCoords(VertexBoxIndex[p]));
+    if(hi-lo<=BOX_LEAF) return;
+    for(c=0,wmax=-1.0,j=0;j<=DIM;j++){ // widest coordinate
+        w=box[VertexSize+j]-box[j];
+        if(w>wmax){ wmax=w; c=j; }
+    }
+    mid=(lo+hi)/2;
+    box_select(lo,hi,mid,c);
+    box_build(2*k,lo,mid); box_build(2*k+1,mid,hi);
+}
+
+/* void box_release(slot)
+*    release a box slot whose reallocation failed */
+static void box_release(memslot_t slot)
+{   dd_stats.total_memory -= memory_slots[slot].rsize;
+    yfree(slot);
+}
+
+static int boxes_ready(void)
+{int i,n,vno,cap; BITMAP_t vl;
+    if(!PARAMS(VertexBoxes) || BoxOff) return 0;
+    if(BoxValid && 4*BoxStale<=BoxVertices) return 1;
+    n=get_vertexnum();
+    cap=n+n/4+BOX_LEAF;
+    BoxNodes=4*((n+BOX_LEAF-1)/BOX_LEAF)+4; // implicit tree node bound
+    yrequest(int,M_VertexBoxIndex,cap,1);
+    yrequest(double,M_VertexBoxStore,BoxNodes+(cap-n+BOX_LEAF-1)/BOX_LEAF,2*VertexSize);
+    if(reallocmem()){ // boxes are optional, go on without them
+        box_release(M_VertexBoxIndex); box_release(M_VertexBoxStore);
+        OUT_OF_MEMORY=0; BoxOff=1; BoxValid=0;
+        report(R_warn,"Not enough memory for vertex boxes, they are not used\n");
+        return 0;
+    }
+    dd_stats.boxrebuilt++;
+    for(n=0,i=0;i<VertexBitmapBlockSize;i++){
+        for(vno=i<<packshift,vl=VertexLiving[i];vl;vno++,vl>>=1)
+            if(vl&1){ VertexBoxIndex[n]=vno; n++; }
+    }
+    if(n>0) box_build(1,0,n);
+    for(i=0;i<n;i++) BoxPos(VertexBoxIndex[i])=i;
+    BoxVertices=n; BoxTail=0; BoxTailCap=cap-n;
+    BoxValid=1; BoxStale=0;
+    return 1;
+}
+
+inline static double box_distance(double *facet,int k)
+{double d=0.0,m=0.0,a,b,*lo,*hi; int j;
+    lo=VertexBox(k); hi=lo+VertexSize;
+    for(j=0;j<=DIM;j++){
+        d += facet[j] * (facet[j]<0.0 ? hi[j] : lo[j]);
+        a= lo[j]<0.0 ? -lo[j] : lo[j]; b= hi[j]<0.0 ? -hi[j] : hi[j];
+        m += (facet[j]<0.0 ? -facet[j] : facet[j]) * (a<b ? b : a);
+    }
+    return d-BOX_MARGIN*m;
+}
+
+static double vertex_distance(double *facet,int vno);
+
+/* int box_probe_node(facet,k,lo,hi,leaf)
+*    negative vertices in node k covering [lo,hi), which is a leaf if
+*    'leaf' is set or it is small enough */
+static int box_probe_node(double *facet, int k, int lo, int hi, int leaf)
+{int p,neg;
+    dd_stats.boxtests++;
+    if(box_distance(facet,k) >= - PARAMS(PolytopeEps)){
+        dd_stats.boxskipped++; return 0; // no negative vertex here
+    }
+    if(!leaf && hi-lo>BOX_LEAF)
+        return box_probe_node(facet,2*k,lo,(lo+hi)/2,0)
+             + box_probe_node(facet,2*k+1,(lo+hi)/2,hi,0);
+    for(neg=0,p=lo;p<hi;p++) if(is_validBoxEntry(p)){
+        if(PARAMS(SealVertices) && is_sealedVertex(VertexBoxIndex[p])) continue;
+        if(vertex_distance(facet,VertexBoxIndex[p]) < - PARAMS(PolytopeEps)) neg++;
+    }
+    return neg;
+}
+
+static int box_probe(double *facet)
+{int c,lo,neg;
+    neg= BoxVertices>0 ? box_probe_node(facet,1,0,BoxVertices,0) : 0;
+    for(c=0,lo=BoxVertices;lo<BoxVertices+BoxTail;c++,lo+=BOX_LEAF){
+        neg += box_probe_node(facet,BoxNodes+c,lo,
+               lo+BOX_LEAF<BoxVertices+BoxTail ? lo+BOX_LEAF : BoxVertices+BoxTail,1);
+    }
+    return neg;
+}
+
+/* void box_positive_node(facet,k,lo,hi,leaf,positive)
+*    mark the vertices of node k which are positive by the box */
+static void box_positive_node(double *facet, int k, int lo, int hi, int leaf,
+           BITMAP_t *positive)
+{int p;
+    dd_stats.boxtests++;
+    if(box_distance(facet,k) > PARAMS(PolytopeEps)){
+        dd_stats.boxskipped++;
+        for(p=lo;p<hi;p++) if(is_validBoxEntry(p))
+            set_bit(positive,VertexBoxIndex[p]);
+        return;
+    }
+    if(!leaf && hi-lo>BOX_LEAF){
+        box_positive_node(facet,2*k,lo,(lo+hi)/2,0,positive);
+        box_positive_node(facet,2*k+1,(lo+hi)/2,hi,0,positive);
+    }
+}
+
+static void box_positive(double *facet, BITMAP_t *positive)
+{int c,lo;
+    memset(positive,0,VertexBitmapBlockSize*sizeof(BITMAP_t));
+    if(BoxVertices>0) box_positive_node(facet,1,0,BoxVertices,0,positive);
+    for(c=0,lo=BoxVertices;lo<BoxVertices+BoxTail;c++,lo+=BOX_LEAF){
+        box_positive_node(facet,BoxNodes+c,lo,
+            lo+BOX_LEAF<BoxVertices+BoxTail ? lo+BOX_LEAF : BoxVertices+BoxTail,1,
+            positive);
+    }
+}
+
 /************************************************************************
 * Initialization
 *
@@ -938,12 +1262,31 @@ int init_dd_structure(int vertexno,int facetno)
     yalloc(BITMAP_t,M_FacetAdjStore,MaxFacets,VertexBitmapBlockSize); // FacetAdjStore
     yalloc(BITMAP_t,M_VertexLiving,1,VertexBitmapBlockSize); // VertexLiving
     yalloc(BITMAP_t,M_VertexFinal,1,VertexBitmapBlockSize); // VertexFinal
+    yalloc(BITMAP_t,M_VertexSealed,1,VertexBitmapBlockSize); // VertexSealed
+    yalloc(BITMAP_t,M_VertexNewFinal,1,VertexBitmapBlockSize); // VertexNewFinal
+    yalloc(double,M_VertexBoxStore,1,2*VertexSize); // VertexBoxStore
+    yalloc(int,M_VertexBoxIndex,1,1); // VertexBoxIndex
+    yalloc(int,M_VertexBoxPos,MaxVertices,1); // VertexBoxPos
     if(OUT_OF_MEMORY) return 1;
     dd_stats.memory_allocated_no=1;
-    NextVertex=0; NextFacet=0;
+    NextVertex=0; NextFacet=0; BoxValid=0; BoxOff=0;
     return 0;
 }
 
+static void release_workers(void); // defined at worker processes
+
+/* void free_dd_structure(void)
+*    release all memory slots, clear the edge funnel counters */
+void free_dd_structure(void)
+{int i;
+    for(i=0;i<M_MSLOTSTOTAL;i++) yfree((memslot_t)i);
+    clear_memory_slots();
+    dd_stats.total_memory=0;
+    NextVertex=0; NextFacet=0;
+    memset(EdgeFunnel,0,sizeof(EdgeFunnel));
+    release_workers();
+}
+
 /* int init_dd(void)
 *    set up the first outer approximation using the given vertex */
 void init_dd(void)
@@ -1006,8 +1349,9 @@ int add_initial_vertex(int final,const double coords[/* 0 .. DIM */])
         report(R_fatal,"Resume: more vertices than specified\n");
         return 1;
     }
+    BoxValid=0;
     set_in_VertexLiving(NextVertex);
-    if(final) set_in_VertexFinal(NextVertex);
+    if(final) mark_vertex_as_final(NextVertex); // seal it at the first iteration
     clear_VertexAdj(NextVertex);
     for(fno=0;fno<NextFacet;fno++){ // which facets it is adjacent to
         w=0.0;
@@ -1066,6 +1410,9 @@ static void allocate_vertex_block(int count)
     yrequest(BITMAP_t,M_VertexAdjStore,MaxVertices,FacetBitmapBlockSize);
     yrequest(BITMAP_t,M_VertexLiving,1,VertexBitmapBlockSize);
     yrequest(BITMAP_t,M_VertexFinal,1,VertexBitmapBlockSize);
+    yrequest(BITMAP_t,M_VertexSealed,1,VertexBitmapBlockSize);
+    yrequest(BITMAP_t,M_VertexNewFinal,1,VertexBitmapBlockSize);
+    yrequest(int,M_VertexBoxPos,MaxVertices,1);
     if(reallocmem()){ // out of memory
         VertexBitmapBlockSize = (MaxVertices+packmask)>>packshift;
         MaxVertices -= total;
@@ -1125,12 +1472,123 @@ static double vertex_distance(double *facet,int vno)
 int probe_facet(double *coords)
 {int vno,negvertex;
     dd_stats.probefacet++; negvertex=0;
+    if(boxes_ready()) return box_probe(coords);
     for(vno=0;vno<NextVertex;vno++) if(is_livingVertex(vno)){
+        if(PARAMS(SealVertices) && is_sealedVertex(vno)) continue;
         if(vertex_distance(coords,vno)< - PARAMS(PolytopeEps) ) negvertex++;
     }
     return negvertex;
 }
 
+/* void probe_facets(int n, double *facets[0:n-1], int score[0:n-1])
+*     score all facets. When PARAMS(ScoreSample) is set and there are
+*     many living vertices, the score is estimated from a sample. The
+*     vertex range is split into ScoreSample strata, and in each round
+*     a living vertex is taken uniformly from each non-empty stratum. A
+*     stratum with L living vertices stands for L vertices, thus the
+*     estimate is sum L*hits/rounds, and the standard error is that of
+*     round*living^2/sum L^2 effective samples. The sample is extended
+*     by another round while the two best candidates are within
+*     SCORE_Z standard errors; if they are still tied after
+*     SCORE_MAXROUNDS rounds, candidates which might be the best are
+*     scored exactly, and the others get score -1 so that only exact
+*     scores are compared. Squares are compared to avoid sqrt(); the
+*     test for a candidate against the best uses
+*     (s1+s2)^2 <= 2(s1^2+s2^2), which keeps a few more candidates. */
+
+#define SCORE_Z		2.0	/* confidence bound in standard errors */
+#define SCORE_MAXROUNDS	8	/* sample rounds before exact scoring */
+
+/* int living_in(int lo, int hi)
+*     the number of living vertices in [lo,hi)
+*  int nth_living(int lo, int hi, int r)
+*     the r-th living vertex in [lo,hi) counting from zero; there must
+*     be more than r living vertices there */
+static int living_in(int lo, int hi)
+{int i,n; BITMAP_t v;
+    for(n=0,i=lo>>packshift;(i<<packshift)<hi;i++){
+        v=VertexLiving[i];
+        if((i<<packshift)<lo) v &= ~(BITMAP_t)0 << (lo&packmask);
+        if(((i+1)<<packshift)>hi) v &= ~(~(BITMAP_t)0 << (hi&packmask));
+        n += get_bitcount(v);
+    }
+    return n;
+}
+
+static int nth_living(int lo, int hi, int r)
+{int i,j,k; BITMAP_t v;
+    for(i=lo>>packshift;(i<<packshift)<hi;i++){
+        v=VertexLiving[i];
+        if((i<<packshift)<lo) v &= ~(BITMAP_t)0 << (lo&packmask);
+        if(((i+1)<<packshift)>hi) v &= ~(~(BITMAP_t)0 << (hi&packmask));
+        k=get_bitcount(v);
+        if(r>=k){ r-=k; continue; }
+        while(r>0){ v &= v-1; r--; } // clear the lower bits
+        for(j=0;(v&1)==0;j++) v>>=1;
+        return (i<<packshift)+j;
+    }
+    return -1; // not reached
+}
+
+void probe_facets(int n, double **facets, int *score)
+{int i,s,vno,living,strata,samples,round,b1,b2,lo,hi; int *cnt;
+ double *wneg,p1,p2,d,v1,sumsq,neff;
+    strata=PARAMS(ScoreSample);
+    for(living=0,i=0;strata>0 && i<VertexBitmapBlockSize;i++)
+        living += get_bitcount(VertexLiving[i]);
+    wneg=NULL; cnt=NULL;
+    if(strata>0 && living>=4*strata && n>0){
+        wneg=calloc(n,sizeof(double)); cnt=malloc(strata*sizeof(int));
+        if(!wneg || !cnt){ free(wneg); free(cnt); wneg=NULL; }
+    }
+    if(!wneg){ // exact scoring
+        for(i=0;i<n;i++) score[i]=probe_facet(facets[i]);
+        return;
+    }
+    dd_stats.probesampled++;
+    for(sumsq=0.0,s=0;s<strata;s++){ // living vertices in the strata
+        cnt[s]=living_in((int)((long long)s*NextVertex/strata),
+                         (int)((long long)(s+1)*NextVertex/strata));
+        sumsq += (double)cnt[s]*(double)cnt[s];
+    }
+    samples=0; b1=b2=0; neff=0.0;
+    for(round=1;;round++){
+        for(s=0;s<strata;s++) if(cnt[s]>0){
+            lo=(int)((long long)s*NextVertex/strata);
+            hi=(int)((long long)(s+1)*NextVertex/strata);
+            vno=nth_living(lo,hi,(int)((random()&0x3fffffff)%cnt[s]));
+            samples++;
+            for(i=0;i<n;i++)
+                if(vertex_distance(facets[i],vno)< - PARAMS(PolytopeEps)) wneg[i]+=cnt[s];
+        }
+        if(n<2) break;
+        neff=(double)round*(double)living*(double)living/sumsq;
+        b1=0; b2=1; if(wneg[b2]>wneg[b1]){ b1=1; b2=0; }
+        for(i=2;i<n;i++){
+            if(wneg[i]>wneg[b1]){ b2=b1; b1=i; }
+            else if(wneg[i]>wneg[b2]) b2=i;
+        }
+        p1=wneg[b1]/((double)round*living); p2=wneg[b2]/((double)round*living);
+        v1=p1*(1.0-p1); d=p1-p2;
+        if(d>0.0 && d*d*neff>SCORE_Z*SCORE_Z*(v1+p2*(1.0-p2)))
+            break; // clear winner
+        if(round>=SCORE_MAXROUNDS || 2*samples>living){ // still tied
+            for(i=0;i<n;i++){
+                p2=wneg[i]/((double)round*living); d=p1-p2;
+                if(d*d*neff<=2.0*SCORE_Z*SCORE_Z*(v1+p2*(1.0-p2))){
+                    // may be the best, score it exactly
+                    score[i]=probe_facet(facets[i]);
+                } else score[i]=-1; // cannot be the best
+                wneg[i]=-1.0;
+            }
+            break;
+        }
+    }
+    for(i=0;i<n;i++) if(wneg[i]>=0.0)
+        score[i]=(int)(wneg[i]/round+0.5);
+    free(wneg); free(cnt);
+}
+
 /***********************************************************************
 * Recompute vertex coordinates from facets adjacent to it
 *
@@ -1274,11 +1732,15 @@ static void thread_recalculate(int threadId) // Id goes from 0 to MaxThreads-1
 }
 
 void recalculate_vertices(void)
+{   phase_begin(0,PH_recalc);
+    BoxValid=0; // coordinates change
 #ifdef USETHREADS
-{  thread_execute(thread_recalculate); }
+    thread_execute(thread_recalculate);
 #else /* ! USETHREADS */
-{   thread_recalculate(0); }
+    thread_recalculate(0);
 #endif /* USETHREADS */
+    phase_end(0,PH_recalc);
+}
 
 /**********************************************************************
 *
@@ -1288,11 +1750,17 @@ void recalculate_vertices(void)
 *    Otherwise intersect all facets containing both vertices; it is
 *    an edge if the intersection contains no other vertices. The first
 *    vertex can be ideal. If no threads, use threadId=0. 
-*    This routine assumes that at least 2 facets contain v1 and v2 */
-inline static int is_edge(int v1,int v2,int threadId)
+*    This routine assumes that at least 2 facets contain v1 and v2.
+*    The edge search counts the outcome in EdgeFunnel[threadId].
+*
+* int edge_test(v1,v2,threadId)
+*    the same test without counting: return -1 if there are too few
+*    common facets, 0 if the scan rejects it, and 1 if it is an edge.
+*    Sealing uses it as its pairs are not part of the edge search. */
+inline static int edge_test(int v1,int v2,int threadId)
 {int facetno,i,j,flistlen; BITMAP_t v; BITMAP_t *f0,*f1;
     if(vertex_intersection(v1,v2) < DIM-1)
-        return 0; // no  - happens frquently
+        return -1; // no  - happens frquently
     /* make a list of all facets adjacent to both v1 and v2,
        and delete v1 and v2 */
     copy_VertexLiving_to(VertexWork(threadId));
@@ -1326,6 +1794,123 @@ inline static int is_edge(int v1,int v2,int threadId)
     return 1; // yes
 }
 
+inline static int is_edge(int v1,int v2,int threadId)
+{int r;
+    r=edge_test(v1,v2,threadId);
+    if(r<0){ EdgeFunnel[threadId].f.few_common++; return 0; }
+    EdgeFunnel[threadId].f.scans++;
+    if(r==0){ EdgeFunnel[threadId].f.scan_reject++; return 0; }
+    EdgeFunnel[threadId].f.edges++;
+    return 1;
+}
+
+/***********************************************************************
+* Sealed vertices
+*
+* A final vertex is sealed if all of its neighbours (vertices connected
+* to it by an edge) are final. Facets added are facets of the final
+* polytope, thus final vertices are never on the negative side, and a
+* sealed vertex cannot be an endpoint of an edge cut by the new facet.
+* Positive sealed vertices are left out of the list of positive
+* vertices, and they are not checked when probing a facet. A sealed
+* vertex keeps its neighbours while it is on the positive side. When it
+* is on the new facet it can get new neighbours, thus it is unsealed.
+* If a final vertex is found on the negative side, its flag is revoked,
+* and vertices which might be its neighbours are unsealed by
+* unseal_around(); they are put back to VertexNewFinal to be sealed
+* again. Vertices marked final since the last iteration, and final
+* vertices read from a resume file are kept in VertexNewFinal;
+* seal_new_final() checks them and their final but unsealed neighbours
+* at the next iteration. The neighbour test does not count in the edge
+* funnel. Used when PARAMS(SealVertices) is set.
+*
+* void union_bitmap(to,from)
+*   add the vertex bitmap 'from' to 'to'
+* int is_neighbour(v1,v2)
+*   v1-v2 is an edge of the approximation
+* void neighbour_candidates(vno,cand)
+*   neighbours share at least DIM-1 facets with vno; if vno is on k
+*   facets, they are on one of any k-DIM+2 facets of vno. Set 'cand'
+*   to the union of the vertices on such facets.
+* void try_seal(vno)
+*   seal the final vertex vno if it has no non-final neighbour
+* void seal_new_final(void)
+*   check vertices marked final since the last call
+* int unseal_around(vno)
+*   unseal the sealed vertices which share DIM-1 facets with vno, and
+*   mark them to be checked again. Return the number of those before
+*   vno, which might have been skipped when classifying vertices.
+*/
+
+inline static void union_bitmap(BITMAP_t *to, const BITMAP_t *from)
+{int i;
+    for(i=0;i<VertexBitmapBlockSize;i++) to[i] |= from[i];
+}
+
+inline static int is_neighbour(int v1, int v2)
+{   if(DIM<=2) return vertex_intersection(v1,v2)!=0;
+    return edge_test(v1,v2,0)>0;
+}
+
+#define VertexSealWork(n)	\
+    (get_memory_ptr(BITMAP_t,M_VertexSealWork)+(n)*VertexBitmapBlockSize)
+
+static void neighbour_candidates(int vno, BITMAP_t *cand)
+{int i,j,fno,need; BITMAP_t fc;
+    for(need=0,i=0;i<FacetBitmapBlockSize;i++)
+        need += get_bitcount(VertexAdj(vno)[i]);
+    if(DIM>2) need -= DIM-2;
+    memset(cand,0,VertexBitmapBlockSize*sizeof(BITMAP_t));
+    for(fno=0,i=0;need>0 && i<FacetBitmapBlockSize;i++,fno+=(1<<packshift)){
+        for(j=fno,fc=VertexAdj(vno)[i];need>0 && fc;j++,fc>>=1) if(fc&1){
+            union_bitmap(cand,FacetAdj(j)); need--;
+        }
+    }
+}
+
+static void try_seal(int vno)
+{int i,u; BITMAP_t w,*cand;
+    cand=VertexSealWork(1); neighbour_candidates(vno,cand);
+    for(i=0;i<VertexBitmapBlockSize;i++)
+        if((w=cand[i] & VertexLiving[i] & ~VertexFinal[i])){
+        for(u=i<<packshift;w;u++,w>>=1)
+            if((w&1) && is_neighbour(vno,u)) return;
+    }
+    set_in_VertexSealed(vno);
+}
+
+static int unseal_around(int vno)
+{int i,n; BITMAP_t w,*cand;
+    cand=VertexSealWork(0); neighbour_candidates(vno,cand);
+    for(n=0,i=0;i<VertexBitmapBlockSize;i++) if((w=cand[i] & VertexSealed[i])){
+        VertexSealed[i] &= ~w; VertexNewFinal[i] |= w;
+        if(i<(vno>>packshift)) n += get_bitcount(w);
+        else if(i==(vno>>packshift))
+            n += get_bitcount(w & ((BITMAP1<<(vno&packmask))-1));
+    }
+    clear_bit(VertexSealed,vno);
+    return n;
+}
+
+static void seal_new_final(void)
+{int i,j,vno,u; BITMAP_t nf,w,*cand;
+    cand=VertexSealWork(0);
+    for(i=0;i<VertexBitmapBlockSize;i++){
+        nf=VertexNewFinal[i] & VertexFinal[i] & VertexLiving[i];
+        VertexNewFinal[i]=0;
+        for(vno=i<<packshift;nf;vno++,nf>>=1) if(nf&1){
+            // neighbours waiting for vno to become final
+            neighbour_candidates(vno,cand);
+            for(j=0;j<VertexBitmapBlockSize;j++)
+                if((w=cand[j] & VertexFinal[j] & ~VertexSealed[j] & VertexLiving[j])){
+                for(u=j<<packshift;w;u++,w>>=1)
+                    if((w&1) && u!=vno && is_neighbour(vno,u)) try_seal(u);
+            }
+            if(!is_sealedVertex(vno)) try_seal(vno);
+        }
+    }
+}
+
 /* void normalize_vertex(nv,d1,d2,v1,v2)
 *    compute d1*v1+d2*v2 => nv, then renormalize so that either new[DIM]=1.0
 *    or new[DIM]=0.0, and the new has L1 norm. */
@@ -1347,26 +1932,38 @@ inline static void normalize_vertex(double *nv,
     for(i=0;i<DIM;i++){v+=nv[i];} v=1.0/v;
     for(i=0;i<DIM;i++){nv[i]*=v;}
 }
-/* void create_new_vertex(v1,v2)
-*    create a new vertex on the edge v1-v2 intersecting the facet ThisFacet
-*    Recalculate the vertex coeffs when ExactVertexEq parameter is set */
-inline static void create_new_vertex(int v1,int v2,int threadId)
-{int newv; double d1,d2; int i;
-    newv=get_new_vertexno(threadId);
-    if(newv<0) return; // no memory
+/* void compute_new_vertex(v1,v2,coords,adj,info,threadId)
+*    compute the coordinates and the adjacency list of the vertex on the
+*    edge v1-v2 intersecting the facet ThisFacet. Recalculate the vertex
+*    coeffs when ExactVertexEq parameter is set; 'info' is reported.
+*  void create_new_vertex(v1,v2,threadId)
+*    create a new vertex on the edge v1-v2 intersecting the facet ThisFacet */
+inline static void compute_new_vertex(int v1,int v2,double *coords,
+       BITMAP_t *adj,int info,int threadId)
+{double d1,d2; int i;
+    EdgeFunnel[threadId].f.new_vertices++;
     // adjacency list is the intersection of that of v1 and v2 plus the new facet
     for(i=0;i<FacetBitmapBlockSize;i++)
-        NewVertexAdj(threadId,newv)[i] = VertexAdj(v1)[i] & VertexAdj(v2)[i];
-    set_bit(NewVertexAdj(threadId,newv),ThisFacet);
+        adj[i] = VertexAdj(v1)[i] & VertexAdj(v2)[i];
+    set_bit(adj,ThisFacet);
     // compute the intersection, v1<0, v2>0
     d1 = -VertexDist(v1); d2 = VertexDist(v2);
-    normalize_vertex(NewVertexCoords(threadId,newv),d2/(d1+d2),d1/(d1+d2),
+    if(d2==DIST_UNKNOWN) d2=vertex_distance(FacetCoords(ThisFacet),v2);
+    normalize_vertex(coords,d2/(d1+d2),d1/(d1+d2),
          VertexCoords(v1),VertexCoords(v2));
     if(PARAMS(ExactVertex))
-        recalculate_vertex(MaxVertices+newv, // report number if error
-            NewVertexAdj(threadId,newv),     // adjacency list
-            NewVertexCoords(threadId,newv),  // old coordinates, replaced
-            threadId);                       // thread
+        recalculate_vertex(info,    // report number if error
+            adj,                    // adjacency list
+            coords,                 // old coordinates, replaced
+            threadId);              // thread
+}
+
+inline static void create_new_vertex(int v1,int v2,int threadId)
+{int newv;
+    newv=get_new_vertexno(threadId);
+    if(newv<0) return; // no memory
+    compute_new_vertex(v1,v2,NewVertexCoords(threadId,newv),
+        NewVertexAdj(threadId,newv),MaxVertices+newv,threadId);
 }
 
 /* void make_vertex_living(vno)
@@ -1374,7 +1971,9 @@ inline static void create_new_vertex(int v1,int v2,int threadId)
 *     of all facets it is adjacent to */
 static void make_vertex_living(int vno)
 {int fno,i,j; BITMAP_t fc;
+    box_insert(vno);
     set_in_VertexLiving(vno);
+    clear_bit(VertexSealed,vno); clear_bit(VertexNewFinal,vno);
     fno=0;for(i=0;i<FacetBitmapBlockSize;i++){
         j=fno; fc=VertexAdj(vno)[i];
         while(fc){
@@ -1393,11 +1992,14 @@ static void make_vertex_living(int vno)
 *    split all cases into ThreadNo pieces; each thread executes one of them.
 *    If there are no threads, ThreadNo=1, and threadId=0 */
 
-static void thread_search_edges(int threadId) // Id goes from 0 to MaxThreads-1
-{int i,j,v1,step; int *PosIdx, *NegIdx;
-    step=ThreadNo; // at least 1
-    NegIdx=VertexPosnegList+(MaxVertices-1-threadId);
-    for(j=threadId;j<dd_stats.vertex_neg;j+=step,NegIdx-=step){
+/* void search_negatives(first,step,threadId)
+*    check the negative vertices first, first+step, ... against all
+*    positive vertices */
+static void search_negatives(int first,int step,int threadId)
+{int i,j,v1; int *PosIdx, *NegIdx;
+    NegIdx=VertexPosnegList+(MaxVertices-1-first);
+    for(j=first;j<dd_stats.vertex_neg;j+=step,NegIdx-=step){
+        EdgeFunnel[threadId].f.pairs += dd_stats.vertex_pos;
         v1=*NegIdx;PosIdx=VertexPosnegList;
         for(i=0;i<dd_stats.vertex_pos;i++,PosIdx++)
             if(is_edge(v1,*PosIdx,threadId))
@@ -1405,12 +2007,223 @@ static void thread_search_edges(int threadId) // Id goes from 0 to MaxThreads-1
     }
 }
 
+static void thread_search_edges(int threadId) // Id goes from 0 to MaxThreads-1
+{   phase_begin(threadId,PH_edges);
+    search_negatives(threadId,ThreadNo,threadId); // ThreadNo is at least 1
+    phase_end(threadId,PH_edges);
+}
+
+static int search_edges_by_workers(void);
+
 static void search_edges(void)
+{   if(search_edges_by_workers()) return;
 #ifdef USETHREADS
-{   thread_execute(thread_search_edges); }
+    thread_execute(thread_search_edges);
 #else /* ! USETHREADS */
-{   thread_search_edges(0); }
+    thread_search_edges(0);
 #endif /* USETHREADS */
+}
+
+/************************************************************************
+*
+*    W O R K E R   P R O C E S S E S
+*
+*************************************************************************
+*
+* When PARAMS(Workers) is at least 2 and there are many pairs to test,
+* the negative vertices are split into Workers shards. Shards 1..Workers-1
+* are handled by forked processes, shard 0 by the calling process. A fork
+* gives each worker a copy-on-write snapshot of the approximation, so
+* only the new vertices travel back: each worker has a region of the
+* shared anonymous arena where it writes them. The caller merges the
+* regions into its own new vertex store. A shard which did not fit into
+* its region, or whose worker failed, is finished by the caller; the
+* region is doubled for the next iteration. The counters a worker hands
+* back cover only the negative vertices it has finished, thus redone
+* pairs are counted once.
+*
+* This is not a sharding of the memory: every worker sees the whole
+* approximation, and the fork itself costs copying the page tables of
+* the process in each big iteration. It gives parallel edge search to
+* a build without USETHREADS; when more than one thread is used, the
+* threads search the edges and workers are not forked.
+*
+* A worker must not write to the files of the caller. Telemetry is
+* switched off in the worker, and it leaves by _exit() without
+* flushing the inherited streams.
+*
+* worker_t
+*    header of a region, filled by the worker
+*
+* void *WorkerArena, size_t WorkerArenaSize
+*    the shared anonymous mapping
+*
+* int WorkerCap
+*    number of vertices a region can hold
+*
+* int WorkerRounds, WorkerMerged, WorkerRedone
+*    statistics
+*/
+
+#include <errno.h>
+#include <unistd.h>	/* fork(), _exit() */
+#include <sys/mman.h>	/* mmap() */
+#include <sys/wait.h>	/* waitpid() */
+
+#define DD_WORKER_MINPAIRS	(1<<20)	/* use workers above that many pairs */
+#define DD_WORKER_MINCAP	4096	/* initial region size in vertices */
+
+typedef struct {
+    int  status;		/* 0: not run, 1: done, 2: stopped at 'next' */
+    int  next;			/* first negative index not handled */
+    int  count;			/* vertices in the region */
+    int  numerical_error;	/* dd_stats increments of the worker */
+    int  instability_warning;
+    EDGE_FUNNEL f;		/* edge test counters of the worker */
+} worker_t;
+
+static void *WorkerArena=NULL;
+static size_t WorkerArenaSize=0;
+static int WorkerCap=DD_WORKER_MINCAP;
+static int WorkerRounds=0, WorkerMerged=0, WorkerRedone=0;
+
+void get_worker_stat(int *rounds, int *merged, int *redone)
+{   *rounds=WorkerRounds; *merged=WorkerMerged; *redone=WorkerRedone; }
+
+/* worker_t *worker_header(w); double *worker_coords(w,k);
+*  BITMAP_t *worker_adj(w,k)
+*    header of region w, coordinates and adjacency list of its k-th vertex */
+#define WorkerRegionSize	\
+    ((size_t)WorkerCap*(VertexSize*sizeof(double)+FacetBitmapBlockSize*sizeof(BITMAP_t)))
+#define worker_header(w)	(((worker_t *)WorkerArena)+(w))
+#define worker_coords(w,k)	\
+    ((double*)(((char *)WorkerArena)+PARAMS(Workers)*sizeof(worker_t)+\
+     (w)*WorkerRegionSize)+(size_t)(k)*VertexSize)
+#define worker_adj(w,k)		\
+    ((BITMAP_t*)(worker_coords(w,WorkerCap))+(size_t)(k)*FacetBitmapBlockSize)
+
+/* void release_workers(void)
+*    unmap the arena and clear the statistics */
+static void release_workers(void)
+{   if(WorkerArena) munmap(WorkerArena,WorkerArenaSize);
+    WorkerArena=NULL; WorkerArenaSize=0; WorkerCap=DD_WORKER_MINCAP;
+    WorkerRounds=0; WorkerMerged=0; WorkerRedone=0;
+}
+
+/* int map_worker_arena(void)
+*    make sure the arena is large enough for the actual sizes. Pages
+*    are not touched, they are backed only when a worker writes there.
+*    Return non-zero if it cannot be mapped. */
+static int map_worker_arena(void)
+{size_t size; void *p;
+    size=PARAMS(Workers)*(sizeof(worker_t)+WorkerRegionSize);
+    size=(size+4095)&~(size_t)4095;
+    if(WorkerArena && WorkerArenaSize>=size) return 0;
+    if(WorkerArena) munmap(WorkerArena,WorkerArenaSize);
+    WorkerArena=NULL; WorkerArenaSize=0;
+    p=mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+    if(p==MAP_FAILED) return 1;
+    WorkerArena=p; WorkerArenaSize=size;
+    return 0;
+}
+
+/* void worker_job(int w)
+*    the job of a forked worker: handle shard w, writing the new vertices
+*    to region w. When the region is full, the vertices of the actual
+*    negative vertex are dropped, and the shard is left for the caller. */
+static void worker_job(int w)
+{int i,j,v1,step,count,start; int *PosIdx, *NegIdx; worker_t *hdr;
+ EDGE_FUNNEL done; int numdone,instdone;
+    int numerr=dd_stats.numerical_error, instab=dd_stats.instability_warning;
+    hdr=worker_header(w); step=PARAMS(Workers); count=0;
+    memset(&EdgeFunnel[0].f,0,sizeof(EDGE_FUNNEL));
+    NegIdx=VertexPosnegList+(MaxVertices-1-w);
+    for(j=w;j<dd_stats.vertex_neg;j+=step,NegIdx-=step){
+        // counters of the finished negative vertices only
+        done=EdgeFunnel[0].f; numdone=dd_stats.numerical_error;
+        instdone=dd_stats.instability_warning;
+        EdgeFunnel[0].f.pairs += dd_stats.vertex_pos;
+        v1=*NegIdx;PosIdx=VertexPosnegList; start=count;
+        for(i=0;i<dd_stats.vertex_pos;i++,PosIdx++) if(is_edge(v1,*PosIdx,0)){
+            if(count>=WorkerCap) goto giveup;
+            compute_new_vertex(v1,*PosIdx,worker_coords(w,count),
+                worker_adj(w,count),MaxVertices+count,0);
+            count++;
+            if(OUT_OF_MEMORY) goto giveup;
+        }
+    }
+    hdr->status=1;
+    goto finish;
+  giveup: // the caller redoes v1 and the rest of the shard, and counts them
+    count=start; hdr->next=j; hdr->status=2;
+    EdgeFunnel[0].f=done; dd_stats.numerical_error=numdone;
+    dd_stats.instability_warning=instdone;
+  finish:
+    hdr->count=count;
+    hdr->numerical_error=dd_stats.numerical_error-numerr;
+    hdr->instability_warning=dd_stats.instability_warning-instab;
+    hdr->f=EdgeFunnel[0].f;
+}
+
+/* int search_edges_by_workers(void)
+*    split the pairs among worker processes if it is worth it and
+*    threads are not used. Return
+*    1 if the search has been done, 0 if the caller should do it. */
+static int search_edges_by_workers(void)
+{int w,k,newv; pid_t *pid; worker_t *hdr; int overflow;
+    if(PARAMS(Workers)<2 || ThreadNo>1) return 0;
+    if((double)dd_stats.vertex_pos*(double)dd_stats.vertex_neg<DD_WORKER_MINPAIRS)
+        return 0;
+    if(map_worker_arena()) return 0;
+    pid=malloc(PARAMS(Workers)*sizeof(pid_t));
+    if(!pid) return 0;
+    WorkerRounds++;
+    memset(WorkerArena,0,PARAMS(Workers)*sizeof(worker_t));
+    fflush(NULL); // do not inherit pending output
+    for(w=1;w<PARAMS(Workers);w++){
+        pid[w]=fork();
+        if(pid[w]==0){ // worker
+            PARAMS(TelemetryFile)=NULL; PARAMS(TraceFile)=NULL;
+            worker_job(w);
+            _exit(0);
+        }
+    }
+    phase_begin(0,PH_edges);
+    search_negatives(0,PARAMS(Workers),0);
+    phase_end(0,PH_edges);
+    phase_begin(0,PH_barrier);
+    for(w=1;w<PARAMS(Workers);w++) if(pid[w]>0)
+        while(waitpid(pid[w],NULL,0)<0 && errno==EINTR);
+    phase_end(0,PH_barrier);
+    free(pid);
+    // merge the regions
+    overflow=0;
+    for(w=1;w<PARAMS(Workers);w++){
+        hdr=worker_header(w);
+        for(k=0;k<hdr->count;k++){
+            newv=get_new_vertexno(0);
+            if(newv<0) break; // no memory
+            memcpy(NewVertexCoords(0,newv),worker_coords(w,k),VertexSize*sizeof(double));
+            memcpy(NewVertexAdj(0,newv),worker_adj(w,k),FacetBitmapBlockSize*sizeof(BITMAP_t));
+            WorkerMerged++;
+        }
+        dd_stats.numerical_error += hdr->numerical_error;
+        dd_stats.instability_warning += hdr->instability_warning;
+        EdgeFunnel[0].f.pairs        += hdr->f.pairs;
+        EdgeFunnel[0].f.few_common   += hdr->f.few_common;
+        EdgeFunnel[0].f.scans        += hdr->f.scans;
+        EdgeFunnel[0].f.scan_reject  += hdr->f.scan_reject;
+        EdgeFunnel[0].f.edges        += hdr->f.edges;
+        EdgeFunnel[0].f.new_vertices += hdr->f.new_vertices;
+        if(hdr->status==1) continue;
+        // finish the shard here
+        WorkerRedone++;
+        if(hdr->status==2) overflow=1;
+        search_negatives(hdr->status==2 ? hdr->next : w,PARAMS(Workers),0);
+    }
+    if(overflow && WorkerCap<(1<<30)/2) WorkerCap *= 2;
+    return 1;
+}
 
 
 /* void compress_from(vno)
@@ -1421,17 +2234,22 @@ static void compress_from(int vno)
     while(vno<NextVertex && is_livingVertex(vno)) vno++;
     while(vno<NextVertex && !is_livingVertex(NextVertex-1)) NextVertex--;
     if(vno<NextVertex){ // vno is empty, NextVertex-1 is used
-        NextVertex--;
+        NextVertex--; BoxStale++;
         move_vertex_to(VertexCoords(NextVertex),VertexAdj(NextVertex),vno);
         make_vertex_living(vno);
         clear_bit(VertexLiving,NextVertex);
+        clear_vertex_in_FacetAdj(NextVertex);
         if(is_finalVertex(NextVertex)) set_in_VertexFinal(vno);
+        if(is_sealedVertex(NextVertex)) set_in_VertexSealed(vno);
+        if(extract_bit(VertexNewFinal,NextVertex)) set_bit(VertexNewFinal,vno);
         vno++; goto fill_holes;
     }
     // clear VertexFinal
-    for(i=0;i<VertexBitmapBlockSize;i++) VertexFinal[i] &= VertexLiving[i];
-    // clear adjacency lists again
-    for(i=0;i<NextFacet;i++) intersect_FacetAdj_VertexLiving(i);
+    for(i=0;i<VertexBitmapBlockSize;i++){
+        VertexFinal[i] &= VertexLiving[i];
+        VertexSealed[i] &= VertexFinal[i];
+        VertexNewFinal[i] &= VertexFinal[i];
+    }
 }
 
 /* void compress_vertices()
@@ -1439,10 +2257,7 @@ static void compress_from(int vno)
 static void compress_vertices(void)
 {int i,vno;
     if(MaxVertices <= get_vertexnum()+2*(DD_VERTEX_ADDBLOCK<<packshift)) return;
-    dd_stats.vertex_compressed_no++;
-    // clear non-living bits in adjacency list of facets
-    for(i=0;i<NextFacet;i++)
-        intersect_FacetAdj_VertexLiving(i);
+    dd_stats.vertex_compressed_no++; BoxValid=0;
     // find the first free vertex slot
     for(i=vno=0;vno<NextVertex &&(~VertexLiving[i])==0;i++,vno+=(1<<packshift));
     compress_from(vno);
@@ -1455,6 +2270,9 @@ static void compress_vertices(void)
     yrequest(BITMAP_t,M_FacetAdjStore,MaxFacets,VertexBitmapBlockSize);
     yrequest(BITMAP_t,M_VertexLiving,1,VertexBitmapBlockSize);
     yrequest(BITMAP_t,M_VertexFinal,1,VertexBitmapBlockSize);
+    yrequest(BITMAP_t,M_VertexSealed,1,VertexBitmapBlockSize);
+    yrequest(BITMAP_t,M_VertexNewFinal,1,VertexBitmapBlockSize);
+    yrequest(int,M_VertexBoxPos,MaxVertices,1);
     if(reallocmem()){ // fatal error
         report(R_fatal,"Compress vertices error, program aborted\n"); 
         exit(4);
@@ -1478,6 +2296,71 @@ inline static void request_main_loop_memory(int threadID)
     MaxNewVertex[threadID]=DD_INITIAL_VERTEXNO;
 }
 
+/* void store_new_vertices(void)
+*    delete negative vertices, and move the new vertices created by the
+*    threads to free slots, allocating more memory if necessary */
+static void store_new_vertices(void)
+{int i,j,vno,threadId,AllNewVertex; BITMAP_t fc; int *NegIdx;
+    // delete negative vertices from VertexLiving
+    BoxStale += dd_stats.vertex_neg;
+    NegIdx=VertexPosnegList+(MaxVertices-1);
+    for(j=0;j<dd_stats.vertex_neg;j++,NegIdx--){ 
+         clear_bit(VertexLiving,*NegIdx);
+         clear_vertex_in_FacetAdj(*NegIdx);
+    }
+    // move new vertices to NextVertex until there is a space
+    AllNewVertex=dd_stats.vertex_new;
+    for(threadId=0;threadId<ThreadNo;threadId++){
+        while(NewVertex[threadId]>0 && NextVertex<MaxVertices){
+            NewVertex[threadId]--; AllNewVertex--;
+            move_NewVertex_th(threadId,NextVertex);
+            make_vertex_living(NextVertex); NextVertex++;
+        }
+        if(NextVertex>=MaxVertices) break;
+        // threadId remains where we need it later
+    }
+    if(AllNewVertex==0) return; // done
+    while(NewVertex[threadId]==0) threadId++;
+    // no more direct space; fill the holes first
+    dd_stats.vertex_compressed_no++;
+    // move new vertices to free vertex slots, if any
+    vno=0; for(i=0;i<VertexBitmapBlockSize;i++){
+        j=vno; fc=~VertexLiving[i]; // complement ...
+        while(fc){
+            while((fc&7)==0){ j+=3; fc>>=3; }
+            if(fc&1){
+                if(j>=MaxVertices) goto finish_compress;
+                NewVertex[threadId]--;
+                move_NewVertex_th(threadId,j);
+                make_vertex_living(j);
+                AllNewVertex--;
+                if(AllNewVertex==0) goto finish_compress;
+                while(NewVertex[threadId]==0) threadId++;
+            }
+            j++; fc>>=1;
+        }
+        vno += (1<<packshift);
+    }
+ finish_compress:
+    if(AllNewVertex>0){ // we still have vertices to be included
+        allocate_vertex_block(AllNewVertex);
+        // if no memory, throw away the rest
+        if(OUT_OF_MEMORY) AllNewVertex=0;
+        else while(1){
+            NewVertex[threadId]--;
+            move_NewVertex_th(threadId,NextVertex);
+            make_vertex_living(NextVertex);
+            NextVertex++;
+            AllNewVertex--;
+            if(AllNewVertex==0) break;
+            while(NewVertex[threadId]==0) threadId++;
+        }
+        return;
+    }
+    // until vno all vertex slots are occupied; compress the rest
+    compress_from(vno);
+}
+
 /* void add_new_facet(double facet[0:DIM])
 *    add a new facet which intersects the present approximation. Split
 *    vertices into postive, zero, and negative sets relative to their position
@@ -1486,8 +2369,7 @@ inline static void request_main_loop_memory(int threadID)
 
 /* add a new facet to the approximation */
 void add_new_facet(double *coords)
-{double d; int i,j,vno,threadId,AllNewVertex; BITMAP_t fc;
- int *PosIdx, *NegIdx;
+{double d; int i,j,vno,threadId,boxes,sealing,sealed; int *PosIdx, *NegIdx;
     dd_stats.iterations++; dd_stats.facetno++;
     if(NextFacet>=MaxFacets){
         compress_vertices();
@@ -1496,6 +2378,7 @@ void add_new_facet(double *coords)
     // memory for the outer loop
     talloc(double,M_VertexDistStore,MaxVertices,1);
     talloc(int,M_VertexPosnegList,MaxVertices,1);
+    if(PARAMS(SealVertices)) talloc(BITMAP_t,M_VertexSealWork,2,VertexBitmapBlockSize);
     for(threadId=0;threadId<ThreadNo;threadId++) request_main_loop_memory(threadId);
     if(OUT_OF_MEMORY){ // indicate that data is till consistent
         dd_stats.data_is_consistent=1;
@@ -1505,11 +2388,27 @@ void add_new_facet(double *coords)
     for(i=0;i<=DIM;i++) FacetCoords(ThisFacet)[i]=coords[i];
     clear_FacetAdj(ThisFacet); // clear the adjacency list
     dd_stats.vertex_pos=0; dd_stats.vertex_neg=0; dd_stats.vertex_zero=0;
+    dd_stats.vertex_sealed=0;
     PosIdx = VertexPosnegList; // this goes ahead
     NegIdx = VertexPosnegList+MaxVertices; // this goes backward
-    for(vno=0;vno<NextVertex;vno++) if(is_livingVertex(vno)){
+    phase_begin(0,PH_classify);
+    sealing=PARAMS(SealVertices);
+    if(sealing) seal_new_final();
+    // VertexWork(0) marks vertices positive by their boxes
+    boxes=boxes_ready();
+    if(boxes) box_positive(coords,VertexWork(0));
+ classify:
+    for(vno=0,sealed=0;vno<NextVertex;vno++) if(is_livingVertex(vno)){
+       if(boxes && extract_bit(VertexWork(0),vno)){
+            if(sealing && is_sealedVertex(vno)){ sealed++; continue; }
+            VertexDist(vno)=DIST_UNKNOWN; // computed when needed
+            *PosIdx=vno; ++PosIdx;
+            dd_stats.vertex_pos++;
+            continue;
+       }
        d=VertexDist(vno)=vertex_distance(coords,vno);
        if(d>PARAMS(PolytopeEps)){ // positive size
+            if(sealing && is_sealedVertex(vno)){ sealed++; continue; }
             *PosIdx=vno; ++PosIdx;
             dd_stats.vertex_pos++;
         } else if(d<-PARAMS(PolytopeEps)){ // negative side
@@ -1519,15 +2418,24 @@ void add_new_facet(double *coords)
                 dd_stats.instability_warning++;
 // it seems the best thing is to revoke the 'final' flag
                 clear_bit(VertexFinal,vno);
+                if(sealing && unseal_around(vno)){ // neighbours might have been left out
+                    clear_FacetAdj(ThisFacet);
+                    dd_stats.vertex_pos=0; dd_stats.vertex_neg=0; dd_stats.vertex_zero=0;
+                    PosIdx = VertexPosnegList; NegIdx = VertexPosnegList+MaxVertices;
+                    goto classify;
+                }
             }
             --NegIdx; *NegIdx = vno;
             dd_stats.vertex_neg++;
         } else { // this is adjacent to our new facet
             set_bit(FacetAdj(ThisFacet),vno);
             set_bit(VertexAdj(vno),ThisFacet);
+            clear_bit(VertexSealed,vno); // it can get new neighbours
             dd_stats.vertex_zero++;
         }
     }
+    dd_stats.vertex_sealed=sealed; dd_stats.sealed_skipped += sealed;
+    phase_end(0,PH_classify);
     if(dd_stats.vertex_neg==0){ // the facet does not cut into the polytope
         dd_stats.vertex_new=0; // no new vertices are added at this step
         if(dd_stats.vertex_zero<DIM){
@@ -1556,17 +2464,22 @@ void add_new_facet(double *coords)
     if(dd_stats.max_tests<d) dd_stats.max_tests=d;
     dd_stats.avg_tests =((dd_stats.iterations-1)*dd_stats.avg_tests+d)
           /((double)dd_stats.iterations);
+    phase_begin(0,PH_search);
     if(DIM <= 2){
         /* search_edges() requires DIIM >=3. For DIM==2, v1-v2 is
            an edge iff there is a facet containing both of them. */
         NegIdx=VertexPosnegList+(MaxVertices-1);
         for(j=0;j<dd_stats.vertex_neg;j++,NegIdx--){
+            EdgeFunnel[0].f.pairs += dd_stats.vertex_pos;
             PosIdx=VertexPosnegList;
             for(i=0;i<dd_stats.vertex_pos;i++,PosIdx++)
-                if(vertex_intersection(*NegIdx,*PosIdx)!=0)
+                if(vertex_intersection(*NegIdx,*PosIdx)!=0){
+                     EdgeFunnel[0].f.edges++;
                      create_new_vertex(*NegIdx,*PosIdx,0);
+                } else EdgeFunnel[0].f.few_common++;
         }
     } else { search_edges(); }
+    phase_end(0,PH_search);
     if(OUT_OF_MEMORY || dobreak){
         dd_stats.vertex_new=0;
         return;
@@ -1575,70 +2488,16 @@ void add_new_facet(double *coords)
     dd_stats.vertex_new=NewVertex[0];
     for(i=1;i<ThreadNo;i++) dd_stats.vertex_new += NewVertex[i];
     // more statistics
-    i=dd_stats.vertex_zero+dd_stats.vertex_pos+dd_stats.vertex_new; // the new vertex number
+    i=dd_stats.vertex_zero+dd_stats.vertex_pos+dd_stats.vertex_sealed+
+      dd_stats.vertex_new; // the new vertex number
     if(dd_stats.max_vertices<i) dd_stats.max_vertices=i;
     if(dd_stats.max_vertexadded < dd_stats.vertex_new)
         dd_stats.max_vertexadded=dd_stats.vertex_new;
     dd_stats.avg_vertexadded = ((dd_stats.iterations-1)*dd_stats.avg_vertexadded+
         (double)dd_stats.vertex_new)/((double)dd_stats.iterations);
-    // delete negative vertices from VertexLiving
-    NegIdx=VertexPosnegList+(MaxVertices-1);
-    for(j=0;j<dd_stats.vertex_neg;j++,NegIdx--){ 
-         clear_bit(VertexLiving,*NegIdx);
-    }
-    // move new vertices to NextVertex until there is a space
-    AllNewVertex=dd_stats.vertex_new;
-    for(threadId=0;threadId<ThreadNo;threadId++){
-        while(NewVertex[threadId]>0 && NextVertex<MaxVertices){
-            NewVertex[threadId]--; AllNewVertex--;
-            move_NewVertex_th(threadId,NextVertex);
-            make_vertex_living(NextVertex); NextVertex++;
-        }
-        if(NextVertex>=MaxVertices) break;
-        // threadId remains where we need it later
-    }
-    if(AllNewVertex==0) return; // done
-    while(NewVertex[threadId]==0) threadId++;
-    // no more direct space; fill the holes first
-    dd_stats.vertex_compressed_no++;
-    // clear the adjacency list of facets
-    for(i=0;i<NextFacet;i++) intersect_FacetAdj_VertexLiving(i);
-    // move new vertices to free vertex slots, if any
-    vno=0; for(i=0;i<VertexBitmapBlockSize;i++){
-        j=vno; fc=~VertexLiving[i]; // complement ...
-        while(fc){
-            while((fc&7)==0){ j+=3; fc>>=3; }
-            if(fc&1){
-                if(j>=MaxVertices) goto finish_compress;
-                NewVertex[threadId]--;
-                move_NewVertex_th(threadId,j);
-                make_vertex_living(j);
-                AllNewVertex--;
-                if(AllNewVertex==0) goto finish_compress;
-                while(NewVertex[threadId]==0) threadId++;
-            }
-            j++; fc>>=1;
-        }
-        vno += (1<<packshift);
-    }
- finish_compress:
-    if(AllNewVertex>0){ // we still have vertices to be included
-        allocate_vertex_block(AllNewVertex);
-        // if no memory, throw away the rest
-        if(OUT_OF_MEMORY) AllNewVertex=0;
-        else while(1){
-            NewVertex[threadId]--;
-            move_NewVertex_th(threadId,NextVertex);
-            make_vertex_living(NextVertex);
-            NextVertex++;
-            AllNewVertex--;
-            if(AllNewVertex==0) break;
-            while(NewVertex[threadId]==0) threadId++;
-        }
-        return;
-    }
-    // until vno all vertex slots are occupied; compress the rest
-    compress_from(vno);
+    phase_begin(0,PH_update);
+    store_new_vertices();
+    phase_end(0,PH_update);
 }
 
 /***********************************************************************
@@ -1802,6 +2661,86 @@ void print_facets(report_type channel)
     }
 }
 
+/* int get_vertex(vno,coords), int get_facet(fno,coords)
+*    coordinates in the direction of the problem, as print_vertex()
+*    and print_facet() report them, without rounding */
+int get_vertex(int vno, double *coords)
+{int j; double dir;
+    if(vno<0 || vno>=NextVertex) return -1;
+    if(!is_livingVertex(vno)) return 0;
+    dir = PARAMS(Direction) ? -1.0 : 1.0;
+    for(j=0;j<DIM;j++) coords[j]=dir*VertexCoords(vno)[j];
+    coords[DIM]=VertexCoords(vno)[DIM];
+    return is_finalVertex(vno) ? 2 : 1;
+}
+
+int get_facet(int fno, double *coords)
+{int j;
+    if(fno<0 || fno>=NextFacet) return -1;
+    for(j=0;j<DIM;j++) coords[j]=FacetCoords(fno)[j];
+    coords[DIM] = PARAMS(Direction) ? -FacetCoords(fno)[DIM] : FacetCoords(fno)[DIM];
+    return 1;
+}
+
+/* int is_proper_facet(int fno)
+*    check if the living vertices adjacent to facet 'fno' span a DIM
+*    dimensional subspace in homogeneous coordinates. Rows of FA are
+*    scaled so that their largest entry is 1, and reduced against the
+*    rows kept earlier; piv[] is the column of the pivot in each. */
+static int is_proper_facet(int fno)
+{int vno,i,j,rank,col; double v,vmax,*FA,*row; int piv[MAXIMAL_ALLOWED_DIMENSION+1];
+    talloc(double,M_FacetArray,DIM+1,DIM+1);
+    if(OUT_OF_MEMORY) return 1; // keep it
+    FA=FacetArray(0); rank=0;
+    for(vno=0;vno<NextVertex && rank<DIM;vno++){
+        if(!extract_bit(FacetAdj(fno),vno)) continue;
+        row=FA+rank*(DIM+1);
+        vmax=0.0; for(i=0;i<=DIM;i++){
+            row[i]=VertexCoords(vno)[i];
+            v=row[i]<0.0 ? -row[i] : row[i]; if(vmax<v) vmax=v;
+        }
+        if(vmax==0.0) continue;
+        for(i=0;i<=DIM;i++) row[i] /= vmax;
+        for(j=0;j<rank;j++) if((v=row[piv[j]])!=0.0){
+            for(i=0;i<=DIM;i++) row[i] -= v*FA[j*(DIM+1)+i];
+        }
+        vmax=0.0; col=0;
+        for(i=0;i<=DIM;i++){
+            v=row[i]<0.0 ? -row[i] : row[i]; if(vmax<v){ vmax=v; col=i; }
+        }
+        if(vmax<PARAMS(LineqEps)) continue; // dependent
+        v=1.0/row[col]; for(i=0;i<=DIM;i++) row[i] *= v;
+        piv[rank]=col; rank++;
+    }
+    return rank>=DIM;
+}
+
+/* int drop_improper_facets(int from, int to)
+*    delete facets from..to-1 which only touch the approximation in a
+*    lower dimensional face. The last facet is moved into the hole,
+*    thus facets are checked downwards. Return the number of facets
+*    deleted. */
+int drop_improper_facets(int from, int to)
+{int fno,last,vno,n;
+    if(to>NextFacet) to=NextFacet;
+    n=0;
+    for(fno=to-1;fno>=from;fno--){
+        if(is_proper_facet(fno)) continue;
+        for(vno=0;vno<NextVertex;vno++) if(extract_bit(FacetAdj(fno),vno))
+            clear_bit(VertexAdj(vno),fno);
+        last=NextFacet-1;
+        if(fno<last){
+            memcpy(FacetCoords(fno),FacetCoords(last),FacetSize*sizeof(double));
+            memcpy(FacetAdj(fno),FacetAdj(last),VertexBitmapBlockSize*sizeof(BITMAP_t));
+            for(vno=0;vno<NextVertex;vno++) if(extract_bit(FacetAdj(fno),vno)){
+                clear_bit(VertexAdj(vno),last); set_bit(VertexAdj(vno),fno);
+            }
+        }
+        NextFacet--; n++;
+    }
+    return n;
+}
+
 /* void make_checpoint(void)
 *     create the next checkpoint file. Fail silently */
 void make_checkpoint(void)
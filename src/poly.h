@@ -72,6 +72,23 @@ void stop_threads(void);
 
 #endif /* USETHREADS */
 
+/************************************************************************
+* Worker processes
+*
+* When PARAMS(Workers) is at least 2, iterations with many vertex pairs
+* to test are split among Workers-1 forked processes and the caller.
+* Workers see a copy-on-write snapshot of the approximation and write
+* the new vertices to a shared memory arena which is merged by the
+* caller. The memory is not sharded, each worker sees the whole
+* approximation; this is meant for builds without USETHREADS.
+*
+* void get_worker_stat(int *rounds, int *merged, int *redone)
+*    iterations using workers, vertices merged from the arena, and
+*    shards finished by the caller as the arena was full or the worker
+*    failed.
+*/
+void get_worker_stat(int *rounds, int *merged, int *redone);
+
 /************************************************************************
 * Statistics
 *
@@ -82,7 +99,8 @@ void stop_threads(void);
 * void get_dd_vertexno(void)
 *   computes the number of verticess of the most recent approximation as
 *   well as how many of them is known to be a facet of the final
-*   polyhedron (living_vertex_no and final_vertex_no). Keeping these 
+*   polyhedron (living_vertex_no and final_vertex_no), and how many
+*   final vertices are sealed (sealed_vertex_no). Keeping these 
 *   values up-to-date at each iteration would be too expensive.
 */
 typedef struct {
@@ -92,6 +110,10 @@ int iterations;		    /* number of iterations which is the same as
 int facetno;                /* facets generated so far */
 int vertexenquiries;	    /* number of times a new vertex was requested */
 int probefacet;		    /* number of time facets were probed */
+int probesampled;	    /* number of times the pool was scored by sampling */
+int boxrebuilt;		    /* number of times vertex boxes were rebuilt */
+double boxtests;	    /* vertex boxes tested against a facet */
+double boxskipped;	    /* boxes on one side of the facet */
 int vertices_allocated_no;  /* number of times vertex space was extended */
 int vertices_allocated;	    /* total number of vertices allocated */
 int facets_allocated_no;    /* number of times facet space was extended */
@@ -100,6 +122,7 @@ int vertex_compressed_no;   /* times vertex compression is called */
 int vertex_pos;             /* last number of positive vertices */
 int vertex_zero;            /* vertices adjacent to the current facet */
 int vertex_neg;             /* negative vertices to be dropped */
+int vertex_sealed;          /* positive sealed vertices left out */
 int vertex_new;             /* total number of vertices added */
 int max_vertices;	    /* maximal number of intermediate vertices */
 int max_vertexadded;	    /* maximal number of vertices added in an iteration */
@@ -108,6 +131,8 @@ double max_tests;	    /* maximal number of edge tests by iterations */
 double avg_tests;	    /* average number of edge tests by iterations */
 int living_vertex_no;	    /* filled by get_dd_vertexno() */
 int final_vertex_no;	    /* filled by get_dd_vertexno() */
+int sealed_vertex_no;	    /* filled by get_dd_vertexno() */
+double sealed_skipped;	    /* positive sealed vertices left out in total */
 int memory_allocated_no;    /* number of times memory expanded */
 size_t total_memory;	    /* total memory (in bytes) actually allocated */
 size_t max_memory;          /* maximum memory allocated so far */
@@ -122,6 +147,28 @@ int data_is_consistent;     /* in case of memory shortage, indicate data consist
 extern DD_STATS dd_stats;
 void get_dd_vertexno(void);
 
+/************************************************************************
+* Edge test funnel
+*
+* The pos x neg vertex pairs of each iteration are tested in stages;
+* these counters tell how many pairs reach a stage. Counters are kept
+* for each thread separately.
+*
+* void get_edge_funnel(int threadId, EDGE_FUNNEL *f)
+*   copy the counters of the given thread to *f. When threadId is
+*   negative, the sum over all threads is returned.
+*/
+typedef struct {
+unsigned long long pairs;	/* vertex pairs tested */
+unsigned long long few_common;	/* rejected: less than DIM-1 common facets */
+unsigned long long scans;	/* pairs reaching the full scan in is_edge() */
+unsigned long long scan_reject;	/* rejected by the full scan */
+unsigned long long edges;	/* edges found */
+unsigned long long new_vertices;/* new vertices created */
+} EDGE_FUNNEL;
+
+void get_edge_funnel(int threadId, EDGE_FUNNEL *f);
+
 /************************************************************************
 * Iterations of the double description algorithm
 *
@@ -132,6 +179,10 @@ void get_dd_vertexno(void);
 *     0:  initialization is succesful
 *     1:  either dimension is too large, or out of memory.
 *
+* void free_dd_structure(void)
+*    release all memory slots and clear the edge funnel counters;
+*    init_dd_structure() can be called again for another problem.
+*
 * void init_dd(void)
 *    initialize the DD algorithm.
 *    Call init_dd_structure(0,0) before this routine.
@@ -165,6 +216,7 @@ void get_dd_vertexno(void);
 
 /** initialize data structures with the first vertex **/
 int init_dd_structure(int vertexno, int facetno);
+void free_dd_structure(void);
 void init_dd(void);
 
 /** add initial vertex and facet **/
@@ -194,6 +246,13 @@ void add_new_facet(double *coords);
 *    to add_new_facet(). The number of vertices thrown away seems to be
 *    a good heuristic.
 *
+* void probe_facets(int n, double *facets[0:n-1], int score[0:n-1])
+*    Score n facets. When PARAMS(ScoreSample) is set and the number of
+*    living vertices is large, the scores are estimated from a
+*    stratified sample of about ScoreSample vertices, which is extended
+*    until the best facet is separated from the rest, or candidates
+*    are scored exactly; then facets which cannot be the best get -1.
+*
 * void recalculate_vertices(void)
 *    Recalculate all vertices from the list of facets adjacent to it. 
 *     When the routine returns, error conditions should be checked.
@@ -204,6 +263,7 @@ int get_vertexnum(void); int get_facetnum(void);
 
 /** facet score, the higher the better **/
 int probe_facet(double *coords);
+void probe_facets(int n, double **facets, int *score);
 
 /** recalculate verteices **/
 void recalculate_vertices(void);
@@ -229,6 +289,22 @@ void recalculate_vertices(void);
 * void print_facets(report_type channel)
 *    Report all living facets of on the given channel using print_facet()
 *
+* int get_vertex(int vno, double coords[0:dim])
+*    If vertex 'vno' is living, copy its coordinates in the direction
+*    of the problem (as printed, without rounding), and return 2 if it
+*    is final, 1 otherwise. Return 0 if it is not living, and -1 if
+*    there are no vertices from 'vno' on.
+*
+* int get_facet(int fno, double coords[0:dim])
+*    copy the equation of facet 'fno' in the direction of the problem
+*    and return 1; return -1 if there are no facets from 'fno' on.
+*
+* int drop_improper_facets(int from, int to)
+*    delete facets from..to-1 whose adjacent vertices span less than
+*    a DIM-1 dimensional face of the approximation; such a hyperplane
+*    supports the polytope but is not a facet. The order of facets
+*    changes. Return the number of facets deleted.
+*
 * void report_memory_usage(report_type ch, int force, char *prompt)
 *    report memory usage of the inner approximation algorithm.
 *
@@ -251,6 +327,13 @@ void print_vertices(report_type channel);
 void print_facet(report_type channel,const double coords[]);
 void print_facets(report_type channel);
 
+/** vertices and facets without formatting **/
+int get_vertex(int vno, double *coords);
+int get_facet(int fno, double *coords);
+
+/** delete supporting hyperplanes which are not facets **/
+int drop_improper_facets(int from, int to);
+
 /** report memory usage **/
 void report_memory_usage(report_type channel, int force, const char *prompt);
 
@@ -22,8 +22,9 @@
 * Report routines
 *
 * int check_outfiles(void)
-*    check files specified in SaveFile, SaveVertexFile, SaveFacetFile
-*    if they are writable. Return 0 if yes, 1 if no.
+*    check files specified in SaveFile, SaveVertexFile, SaveFacetFile,
+*    TelemetryFile, TraceFile and QueryFile if they are writable. Return
+*    0 if yes, 1 if no.
 *
 * int checkfile(char *fname)
 *    open file 'fname' for writing, and close immediately. Return 0 if
@@ -35,11 +36,18 @@
 * void report(channel, format, ...)
 *    send the value to the given channel; suppress message depending
 *    on PARAMS(). Flush immediately for R_info; save on other types. 
-*    Channels R_savefacet and R_savevertex open files specified in 
-*    PARAMS().
+*    Channels R_savefacet, R_savevertex, R_telemetry and R_query open
+*    files specified in PARAMS().
+*
+* int open_telemetryfile(void)
+*    open PARAMS(TelemetryFile) if it is not open yet. report() does it
+*    lazily; call it from the main thread before the worker threads are
+*    created as telemetry_memory() may write from any thread. Return
+*    non-zero if the file is open.
 *
 * void close_savefiles(void)
-*    close files corresponding to R_savevertex and R_savefacet
+*    close files corresponding to R_savevertex, R_savefacet,
+*    R_telemetry and R_query
 */
 
 static int checkfile(const char *fname)
@@ -55,7 +63,10 @@ int check_outfiles(void)
 {
     return checkfile(PARAMS(SaveFile)) ||
            checkfile(PARAMS(SaveVertexFile)) ||
-           checkfile(PARAMS(SaveFacetFile));
+           checkfile(PARAMS(SaveFacetFile)) ||
+           checkfile(PARAMS(TelemetryFile)) ||
+           checkfile(PARAMS(TraceFile)) ||
+           checkfile(PARAMS(QueryFile));
 }
 
 /***********************************************************************
@@ -63,9 +74,15 @@ int check_outfiles(void)
 * int pending_output
 *    non-zero if there is a pending output on stdout
 *
-* FILE *savefile, *savevertexfile, *savefacetfile, *chkfile
+* FILE *savefile, *savevertexfile, *savefacetfile, *chkfile, *telfile,
+*      *tracefile, *queryfile
 *    either NULL or the opened stream handle for that channel.
 *
+* int TELEMETRY_BUFSIZE
+*    telemetry records, trace events and oracle queries are written through a buffer
+*    of this size so that the main loop is not slowed down by small
+*    writes.
+*
 * int open_vertexfile(void)
 *    if savevertexfile is not open, open it. Take care if it is
 *    the same as savefacetfile, and that has been opened.
@@ -76,7 +93,14 @@ int check_outfiles(void)
 */
 static int pending_output=0;
 static FILE *savefile=NULL, *savevertexfile=NULL, 
-            *savefacetfile=NULL, *chkfile=NULL;
+            *savefacetfile=NULL, *chkfile=NULL, *telfile=NULL,
+            *tracefile=NULL, *queryfile=NULL;
+
+#define TELEMETRY_BUFSIZE	(1<<20)	/* 1 Mbyte */
+
+/* in a sweep the files are reopened for each variant; check_outfiles()
+   has truncated them at the start */
+#define SAVEMODE	(PARAMS(SweepFile) ? "a" : "w")
 
 static int open_vertexfile(void)
 {   if(savevertexfile) return 1;
@@ -85,7 +109,7 @@ static int open_vertexfile(void)
        && savefacetfile){
          savevertexfile=savefacetfile; return 1;
     }
-    savevertexfile=fopen(PARAMS(SaveVertexFile),"w");
+    savevertexfile=fopen(PARAMS(SaveVertexFile),SAVEMODE);
     return savevertexfile!=NULL;
 }
 
@@ -96,7 +120,7 @@ static int open_facetfile(void)
        && savevertexfile){
         savefacetfile=savevertexfile; return 1;
     }
-    savefacetfile=fopen(PARAMS(SaveFacetFile),"w");
+    savefacetfile=fopen(PARAMS(SaveFacetFile),SAVEMODE);
     return savefacetfile!=NULL;
 }
 
@@ -121,7 +145,7 @@ void report(report_type channel, const char *fmt,...)
     }
     if(channel==R_savefacet){
         if(PARAMS(SaveFile) && PARAMS(SaveFacets)){
-            if(!savefile) savefile=fopen(PARAMS(SaveFile),"w");
+            if(!savefile) savefile=fopen(PARAMS(SaveFile),SAVEMODE);
             if(savefile){
               va_start(arg,fmt); vfprintf(savefile,fmt,arg); va_end(arg);
             }
@@ -131,7 +155,7 @@ void report(report_type channel, const char *fmt,...)
         }
     } else if(channel==R_savevertex){
         if(PARAMS(SaveFile) && PARAMS(SaveVertices)){
-            if(!savefile) savefile=fopen(PARAMS(SaveFile),"w");
+            if(!savefile) savefile=fopen(PARAMS(SaveFile),SAVEMODE);
             if(savefile){
               va_start(arg,fmt); vfprintf(savefile,fmt,arg); va_end(arg);
             }
@@ -143,6 +167,23 @@ void report(report_type channel, const char *fmt,...)
         if(chkfile){
           va_start(arg,fmt); vfprintf(chkfile,fmt,arg); va_end(arg);
         }
+    } else if(channel==R_telemetry){
+        if(telfile || open_telemetryfile()){
+          va_start(arg,fmt); vfprintf(telfile,fmt,arg); va_end(arg);
+        }
+    } else if(channel==R_trace){
+        if(tracefile){
+          va_start(arg,fmt); vfprintf(tracefile,fmt,arg); va_end(arg);
+        }
+    } else if(channel==R_query){
+        if(!queryfile && PARAMS(QueryFile)){
+            queryfile=fopen(PARAMS(QueryFile),SAVEMODE);
+            if(queryfile) setvbuf(queryfile,NULL,_IOFBF,TELEMETRY_BUFSIZE);
+            else PARAMS(QueryFile)=NULL; // don't try again
+        }
+        if(queryfile){
+          va_start(arg,fmt); vfprintf(queryfile,fmt,arg); va_end(arg);
+        }
     }
 }
 
@@ -153,6 +194,17 @@ void close_savefiles(void)
         fclose(savevertexfile); savevertexfile=NULL;
     }
     if(savefacetfile){ fclose(savefacetfile); savefacetfile=NULL; }
+    if(telfile){ fclose(telfile); telfile=NULL; }
+    if(queryfile){ fclose(queryfile); queryfile=NULL; }
+}
+
+int open_telemetryfile(void)
+{   if(telfile) return 1;
+    if(!PARAMS(TelemetryFile)) return 0;
+    telfile=fopen(PARAMS(TelemetryFile),SAVEMODE);
+    if(telfile) setvbuf(telfile,NULL,_IOFBF,TELEMETRY_BUFSIZE);
+    else PARAMS(TelemetryFile)=NULL; // don't try again
+    return telfile!=NULL;
 }
 
 void flush_report(void)
@@ -201,5 +253,15 @@ void open_dumpfile(void)
 void close_dumpfile(void)
 {   if(chkfile){ fclose(chkfile); chkfile=NULL; } }
 
+void open_tracefile(void)
+{   if(tracefile){ fclose(tracefile); tracefile=NULL; }
+    if(PARAMS(TraceFile)==NULL) return;
+    tracefile=fopen(PARAMS(TraceFile),"w"); // truncate or create
+    if(tracefile) setvbuf(tracefile,NULL,_IOFBF,TELEMETRY_BUFSIZE);
+}
+
+void close_tracefile(void)
+{   if(tracefile){ fclose(tracefile); tracefile=NULL; } }
+
 /* EOF */
 
@@ -25,7 +25,8 @@
 *    flush pending messages at stdout
 *
 * void close_savefiles(void)
-*    close files corresponding to R_savevertex and R_savefacet
+*    close files corresponding to R_savevertex, R_savefacet,
+*    R_telemetry and R_query
 *
 * int check_outfiles(void)
 *    check that all result files are writable. Do it before starting
@@ -44,6 +45,16 @@
 *
 * void close_dumpfile(void)
 *    close the most recently opened dumpfile
+*
+* int open_telemetryfile(void)
+*    open PARAMS(TelemetryFile) unless it is open; call it before the
+*    worker threads are created
+*
+* void open_tracefile(void)
+*    create (truncate) the trace event file PARAMS(TraceFile)
+*
+* void close_tracefile(void)
+*    close the trace event file
 */
 
 /* report channel */
@@ -55,7 +66,10 @@ R_txt,		/* report message */
 R_info,		/* info + flush */
 R_savefacet,	/* save facets, go to result file */
 R_savevertex,	/* save vertices, go to result file */
-R_chk		/* checkpoint file */
+R_chk,		/* checkpoint file */
+R_telemetry,	/* telemetry records, buffered */
+R_trace,	/* trace events */
+R_query		/* oracle queries and answers, buffered */
 } report_type;
 
 /** report the message to the given channel */
@@ -65,6 +79,9 @@ __attribute__((format(printf,2,3)))
 #endif
 ;
 
+/** open the telemetry file before threads start **/
+int open_telemetryfile(void);
+
 /** close result files **/
 void close_savefiles(void);
 
@@ -82,5 +99,9 @@ void close_checkpoint(void);
 void open_dumpfile(void);
 void close_dumpfile(void);
 
+/** open and close trace event file **/
+void open_tracefile(void);
+void close_tracefile(void);
+
 /* EOF */
 
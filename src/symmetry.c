@@ -0,0 +1,263 @@
+/** symmetry.c  --  permutation symmetries of the objectives **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "report.h"
+#include "params.h"
+#include "hashkey.h"
+#include "poly.h"
+#include "symmetry.h"
+
+/***********************************************************************
+* Symmetry data
+*
+* int gens
+*    number of generators, zero if there is no symmetry
+*
+* int *gen
+*    gen[g*DIM+i] is the image of coordinate i under generator g
+*
+* SYM_MAXORBIT
+*    orbits are computed up to this size
+*
+* keyset_t seen, finalset
+*    hash sets of 128 bit keys of vectors computed by vector_key():
+*    'seen' is the orbit under construction, 'finalset' contains the
+*    images of final vertices
+*
+* double *orbit, int orbitmax
+*    the orbit under construction, space for orbitmax vectors
+*
+* double *pending, int pending_head, pending_no, pending_max
+*    queued facet images; pending_head is the next one
+*
+* int stat_queued, stat_added, stat_saved, stat_truncated
+*    statistics
+*/
+
+#define DIM		PARAMS(ProblemObjects)
+#define SYM_MAXORBIT	100000
+
+static int gens=0;
+static int *gen=NULL;
+static keyset_t seen={NULL,0,0}, finalset={NULL,0,0};
+static double *orbit=NULL; static int orbitmax=0;
+static double *pending=NULL; static int pending_head=0, pending_no=0, pending_max=0;
+static int stat_queued=0, stat_added=0, stat_saved=0, stat_truncated=0;
+
+int symmetry_generators(void){ return gens; }
+
+void get_symmetry_stat(int *queued, int *added, int *saved, int *truncated)
+{   *queued=stat_queued; *added=stat_added; *saved=stat_saved;
+    *truncated=stat_truncated;
+}
+
+/* void no_memory(void)
+*    out of memory: symmetries are an optimization only, so warn and
+*    continue without them */
+static void no_memory(void)
+{   report(R_warn,"symmetry: out of memory, symmetries are not used\n");
+    gens=0; pending_head=pending_no=0;
+}
+
+/***********************************************************************
+* Orbits
+*
+* int compute_orbit(const double v[0:DIM])
+*    store the orbit of v in orbit[]; v is the first element. Images
+*    are generated by applying the generators to the elements found so
+*    far. Return the size of the orbit, or -1 if out of memory.
+*/
+
+static int compute_orbit(const double *v)
+{int k,g,i,n,r; double *from,*img; uint64_t key,check;
+    if(orbitmax==0){
+        orbit=malloc(64*(DIM+1)*sizeof(double));
+        if(!orbit) return -1;
+        orbitmax=64;
+    }
+    keyset_clear(&seen);
+    memcpy(orbit,v,(DIM+1)*sizeof(double));
+    vector_key(v,0,FNV_OFFSET,&key,&check);
+    if(keyset_add(&seen,key,check)<0) return -1;
+    n=1;
+    for(k=0;k<n;k++) for(g=0;g<gens;g++){
+        if(n>=SYM_MAXORBIT){ stat_truncated++; return n; }
+        if(n>=orbitmax){ // keep the old block if it cannot be extended
+            img=realloc(orbit,2*orbitmax*(DIM+1)*sizeof(double));
+            if(!img) return -1;
+            orbit=img; orbitmax*=2;
+        }
+        from=orbit+k*(DIM+1); img=orbit+n*(DIM+1);
+        for(i=0;i<DIM;i++) img[gen[g*DIM+i]]=from[i];
+        img[DIM]=from[DIM];
+        vector_key(img,0,FNV_OFFSET,&key,&check);
+        r=keyset_add(&seen,key,check);
+        if(r<0) return -1;
+        if(r) n++;
+    }
+    return n;
+}
+
+/***********************************************************************
+* Facet images and final vertices
+*/
+
+void symmetry_new_facet(const double *facet)
+{int n,k; double *p;
+    if(!gens) return;
+    n=compute_orbit(facet);
+    if(n<0){ no_memory(); return; }
+    if(pending_no+n>pending_max){
+        p=realloc(pending,2*(pending_no+n)*(DIM+1)*sizeof(double));
+        if(!p){ no_memory(); return; }
+        pending=p; pending_max=2*(pending_no+n);
+    }
+    for(k=1;k<n;k++){ // the first one is the facet itself
+        memcpy(pending+pending_no*(DIM+1),orbit+k*(DIM+1),(DIM+1)*sizeof(double));
+        pending_no++;
+    }
+    stat_queued += n-1;
+}
+
+int symmetry_next_facet(double *facet)
+{double *f;
+    while(pending_head<pending_no){
+        f=pending+pending_head*(DIM+1); pending_head++;
+        if(probe_facet(f)>0){ // it cuts into the approximation
+            memcpy(facet,f,(DIM+1)*sizeof(double));
+            stat_added++;
+            return 1;
+        }
+    }
+    pending_head=pending_no=0;
+    return 0;
+}
+
+int symmetry_cut(const double *vertex)
+{int k,i; double d,*f;
+    for(k=pending_head;k<pending_no;k++){
+        f=pending+k*(DIM+1);
+        for(d=0.0,i=0;i<=DIM;i++) d += f[i]*vertex[i];
+        if(d < -PARAMS(PolytopeEps)){ stat_saved++; return 1; }
+    }
+    return 0;
+}
+
+void symmetry_final_vertex(const double *vertex)
+{int n,k; uint64_t key,check;
+    if(!gens) return;
+    n=compute_orbit(vertex);
+    if(n<0){ no_memory(); return; }
+    for(k=0;k<n;k++){
+        vector_key(orbit+k*(DIM+1),0,FNV_OFFSET,&key,&check);
+        if(keyset_add(&finalset,key,check)<0){ no_memory(); return; }
+    }
+}
+
+int symmetry_is_final(const double *vertex)
+{uint64_t key,check;
+    if(!gens) return 0;
+    vector_key(vertex,0,FNV_OFFSET,&key,&check);
+    if(!keyset_has(&finalset,key,check)) return 0;
+    stat_saved++;
+    return 1;
+}
+
+/***********************************************************************
+* Reading the generators
+*
+* int parse_generator(char *str, const char *fname, int lineno)
+*    parse the permutation p1 ... pd in str[] and store it as the next
+*    generator. The identity is skipped. Return non-zero on error.
+*
+* void symmetry_release(void)
+*    forget the generators, the queue and the final orbits
+*
+* int symmetry_init(void)
+*    read the generators from PARAMS(SymmetryFile) or from the
+*    'c symmetry' lines of PARAMS(VlpFile)
+*/
+
+static int parse_generator(char *str, const char *fname, int lineno)
+{int i,identity; long p; char *end; int *g;
+    g=realloc(gen,(gens+1)*DIM*sizeof(int));
+    if(!g){ // gen[] is released by symmetry_release()
+        report(R_fatal,"symmetry: out of memory\n");
+        return 1;
+    }
+    gen=g; g=gen+gens*DIM;
+    for(i=0;i<DIM;i++) g[i]=-1;
+    identity=1;
+    for(i=0;i<DIM;i++){
+        p=strtol(str,&end,10);
+        if(end==str || p<1 || p>DIM) break;
+        str=end; g[i]=(int)p-1;
+        if(g[i]!=i) identity=0;
+    }
+    while(*str==' '||*str=='\t'||*str=='\r'||*str=='\n') str++;
+    if(i==DIM && !*str){ // check that it is a permutation
+        for(i=0;i<DIM;i++){
+            int j; for(j=i+1;j<DIM && g[j]!=g[i];j++);
+            if(j<DIM) break;
+        }
+    }
+    if(i<DIM || *str){
+        report(R_fatal,"symmetry: line %d of %s is not a permutation of 1..%d\n",
+            lineno,fname,DIM);
+        return 1;
+    }
+    if(!identity) gens++;
+    return 0;
+}
+
+void symmetry_release(void)
+{   free(gen); gen=NULL; gens=0;
+    keyset_free(&seen); keyset_free(&finalset);
+    free(orbit); orbit=NULL; orbitmax=0;
+    free(pending); pending=NULL; pending_head=pending_no=pending_max=0;
+    stat_queued=stat_added=stat_saved=stat_truncated=0;
+}
+
+int symmetry_init(void)
+{FILE *f; const char *fname; char *line=NULL; size_t linesize=0; int lineno;
+    symmetry_release();
+    if(!PARAMS(Symmetry)) return 0;
+    fname = PARAMS(SymmetryFile) ? PARAMS(SymmetryFile) : PARAMS(VlpFile);
+    f=fopen(fname,"r");
+    if(!f){
+        report(R_fatal,"symmetry: cannot open %s for reading\n",fname);
+        return 1;
+    }
+    lineno=0;
+    while(getline(&line,&linesize,f)>0){
+        lineno++;
+        if(PARAMS(SymmetryFile)){
+            if(line[0]!='G') continue;
+            if(parse_generator(line+1,fname,lineno)){ fclose(f); free(line); return 1; }
+        } else {
+            if(strncmp(line,"c symmetry ",11)!=0) continue;
+            if(parse_generator(line+11,fname,lineno)){ fclose(f); free(line); return 1; }
+        }
+    }
+    fclose(f); free(line);
+    if(gens) report(R_info,"C symmetry group with %d generator%s\n",
+        gens,gens>1?"s":"");
+    return 0;
+}
+
+/* EOF */
+
@@ -0,0 +1,72 @@
+/** symmetry.h  --  permutation symmetries of the objectives **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Symmetry group
+*
+* The solution can be invariant under a group of permutations of the
+* objectives. The group is specified by its generators, either by the
+* comment lines
+*    c symmetry p1 p2 ... pd
+* of the vlp file, or by the lines
+*    G p1 p2 ... pd
+* of the file given by the option --symmetry=<file>. The generator
+* moves objective i to objective p_i. Vertices and facets are moved
+* by permuting their first d coordinates. When the oracle returns a
+* facet, all of its images are facets of the solution; when it says
+* that a vertex is final, all of its images are final.
+*
+* int symmetry_init(void)
+*    read the generators when PARAMS(Symmetry) is set. Call after
+*    load_vlp(). Return non-zero on error; the error is reported.
+*
+* void symmetry_release(void)
+*    free all memory; symmetry_init() can be called again
+*
+* int symmetry_generators(void)
+*    the number of generators; zero if there are no symmetries
+*
+* void symmetry_new_facet(const double facet[0:dim])
+*    the oracle returned this facet; queue all of its other images
+*
+* int symmetry_next_facet(double facet[0:dim])
+*    copy the next queued image which cuts into the approximation to
+*    facet[] and return 1. Images which don't cut are dropped. Return
+*    0 if the queue is empty.
+*
+* int symmetry_cut(const double vertex[0:dim])
+*    return 1 if a queued image cuts off this vertex
+*
+* void symmetry_final_vertex(const double vertex[0:dim])
+*    the oracle said the vertex is final; remember its orbit
+*
+* int symmetry_is_final(const double vertex[0:dim])
+*    return 1 if the vertex is the image of a final vertex
+*
+* void get_symmetry_stat(int *queued, int *added, int *saved, int *truncated)
+*    facet images queued and added, oracle calls saved, and orbits
+*    which were not computed completely.
+*/
+
+int symmetry_init(void);
+void symmetry_release(void);
+int symmetry_generators(void);
+void symmetry_new_facet(const double *facet);
+int symmetry_next_facet(double *facet);
+int symmetry_cut(const double *vertex);
+void symmetry_final_vertex(const double *vertex);
+int symmetry_is_final(const double *vertex);
+void get_symmetry_stat(int *queued, int *added, int *saved, int *truncated);
+
+/* EOF */
+
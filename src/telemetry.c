@@ -0,0 +1,498 @@
+/** telemetry.c  --  phase timers and machine readable run data **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>	/* clock_gettime() */
+#include <unistd.h>	/* getpid(), ftruncate() */
+#include <fcntl.h>	/* open() */
+#include <sys/mman.h>	/* mmap() */
+#include <sys/time.h>	/* gettimeofday() */
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define HAVE_PERF_EVENTS
+#endif
+#include "report.h"
+#include "params.h"
+#include "poly.h"
+#include "glp_oracle.h"
+#include "telemetry.h"
+#include "livestat.h"
+
+/***********************************************************************
+* Phase timers
+*
+* phase_timer_t PhaseTimer[MAX_THREADS]
+*    start time and accumulated total of each phase, one block for
+*    each thread. The padding keeps blocks of different threads in
+*    different cache lines.
+*
+* char *phase_names[PH_MAX]
+*    the phase names as used in reports
+*/
+
+typedef struct {
+    double start[PH_MAX];	/* when the phase started */
+    double total[PH_MAX];	/* total time spent in the phase */
+    char   pad[64];		/* avoid false sharing */
+} phase_timer_t;
+
+static phase_timer_t PhaseTimer[MAX_THREADS];
+
+static const char *phase_names[PH_MAX]={
+    "oracle","probe","classify","search","update","recalc","checkpoint",
+    "edges","barrier"
+};
+
+static void trace_event(int threadId, phase_t ph, double start, double end);
+static void perf_sample(int threadId, int ph, int end);
+
+double phase_clock(void)
+{struct timespec ts; static time_t startsec=0;
+    if(clock_gettime(CLOCK_MONOTONIC,&ts)) return 0.0;
+    if(startsec==0) startsec=ts.tv_sec;
+    return (double)(ts.tv_sec-startsec)+1e-9*(double)ts.tv_nsec;
+}
+
+void phase_begin(int threadId, phase_t ph)
+{   if(PARAMS(PerfCounters)) perf_sample(threadId,ph,0);
+    PhaseTimer[threadId].start[ph]=phase_clock();
+}
+
+void phase_end(int threadId, phase_t ph)
+{double now;
+    now=phase_clock();
+    if(PARAMS(PerfCounters)) perf_sample(threadId,ph,1);
+    PhaseTimer[threadId].total[ph] += now-PhaseTimer[threadId].start[ph];
+    if(PARAMS(TraceFile))
+        trace_event(threadId,ph,PhaseTimer[threadId].start[ph],now);
+}
+
+double phase_total(int threadId, phase_t ph)
+{   return PhaseTimer[threadId].total[ph]; }
+
+const char *phase_name(phase_t ph)
+{   return ph<PH_MAX ? phase_names[ph] : "?"; }
+
+/* const char *json_escape(char *buf, int size, const char *s)
+*    copy s to buf[0:size-1] as the content of a JSON string: quote,
+*    backslash and control characters are escaped. Too long strings
+*    are truncated. Return buf. */
+static const char *json_escape(char *buf, int size, const char *s)
+{int n=0; unsigned char c;
+    while(s && (c=(unsigned char)*s) && n<size-7){
+        if(c=='"' || c=='\\'){ buf[n++]='\\'; buf[n++]=c; }
+        else if(c<0x20){ sprintf(buf+n,"\\u%04x",c); n+=6; }
+        else buf[n++]=c;
+        s++;
+    }
+    buf[n]=0;
+    return buf;
+}
+
+void telemetry_memory(int slot, const char *title, const char *kind,
+    size_t oldsize, size_t newsize, size_t blocks, size_t blocksize,
+    size_t moved, double elapsed)
+{char tbuf[64];
+    if(!PARAMS(TelemetryFile)) return;
+    report(R_telemetry,"{\"type\":\"mem\",\"iter\":%d,\"time\":%.4f,"
+        "\"slot\":%d,\"title\":\"%s\",\"kind\":\"%s\",\"old\":%zu,"
+        "\"new\":%zu,\"blocks\":%zu,\"blocksize\":%zu,\"moved\":%zu,"
+        "\"elapsed\":%.6f}\n",
+        dd_stats.iterations,phase_clock(),slot,
+        json_escape(tbuf,sizeof(tbuf),title),kind,oldsize,newsize,
+        blocks,blocksize,moved,elapsed);
+}
+
+/***********************************************************************
+* Hardware counters
+*
+* char perf_phase[PH_MAX]
+*    phases where counters are sampled. Reading the counters is a
+*    system call, thus only the hot phases are sampled.
+*
+* perf_counter_t PerfCounter[MAX_THREADS]
+*    counters of each thread. The counters form a single group led by
+*    the cycle counter so that they are read together. The extra two
+*    values are the time the group was enabled and running; they are
+*    used to scale the values when the kernel multiplexes counters.
+*
+* int perf_open(int threadId)
+*    open the counters of the calling thread, which is threadId.
+*    Return 1 if successful, -1 if counters are not available.
+*
+* int perf_read(int threadId, unsigned long long val[PC_MAX+2])
+*    read all counters of the group; return 0 if successful.
+*
+* void perf_close(int threadId)
+*    close the counters opened by perf_open()
+*
+* void perf_sample(int threadId, int ph, int end)
+*    take the counter values at the beginning or end of phase 'ph'.
+*    Counters are opened at the first call in each thread.
+*/
+
+static const char perf_phase[PH_MAX]={
+    1 /* oracle */, 1 /* probe */, 1 /* classify */, 1 /* search */,
+    0, 0, 0, 1 /* edges */, 0
+};
+
+#define PC_ENABLED	PC_MAX		/* time the group was enabled */
+#define PC_RUNNING	(PC_MAX+1)	/* time the group was counting */
+
+typedef struct {
+    int    state;		/* 0: not opened, 1: counting, -1: failed */
+    int    n;			/* number of counters in the group */
+    int    fd[PC_MAX];		/* file descriptors, -1 if not opened */
+    int    idx[PC_MAX];		/* position in the group, -1 if none */
+    unsigned long long start[PH_MAX][PC_MAX+2]; /* at phase start */
+    unsigned long long total[PH_MAX][PC_MAX+2]; /* accumulated */
+    char   pad[64];		/* avoid false sharing */
+} perf_counter_t;
+
+static perf_counter_t PerfCounter[MAX_THREADS];
+
+#ifdef HAVE_PERF_EVENTS
+static int perf_open(int threadId)
+{perf_counter_t *pc; struct perf_event_attr attr; int i;
+    static const struct { unsigned type; unsigned long long config; }
+    events[PC_MAX]={
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+          (PERF_COUNT_HW_CACHE_OP_READ<<8) | (PERF_COUNT_HW_CACHE_RESULT_MISS<<16)},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+          (PERF_COUNT_HW_CACHE_OP_READ<<8) | (PERF_COUNT_HW_CACHE_RESULT_MISS<<16)},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+    pc=&PerfCounter[threadId];
+    pc->n=0;
+    for(i=0;i<PC_MAX;i++){
+        pc->fd[i]=-1; pc->idx[i]=-1;
+        memset(&attr,0,sizeof(attr));
+        attr.size=sizeof(attr);
+        attr.type=events[i].type;
+        attr.config=events[i].config;
+        attr.read_format=PERF_FORMAT_GROUP|
+            PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel=1; attr.exclude_hv=1;
+        /* pid=0, cpu=-1: the calling thread on any CPU */
+        pc->fd[i]=(int)syscall(__NR_perf_event_open,&attr,0,-1,
+                      i==0 ? -1 : pc->fd[0],0);
+        if(pc->fd[i]<0){
+            pc->fd[i]=-1;
+            if(i==0) return -1; /* no cycle counter, give up */
+            continue;
+        }
+        pc->idx[i]=pc->n; pc->n++;
+    }
+    return 1;
+}
+
+static int perf_read(int threadId, unsigned long long val[PC_MAX+2])
+{perf_counter_t *pc; unsigned long long buf[3+PC_MAX]; int i;
+    pc=&PerfCounter[threadId];
+    if(read(pc->fd[0],buf,sizeof(buf))<(ssize_t)((3+pc->n)*sizeof(buf[0]))
+       || buf[0]!=(unsigned long long)pc->n) return 1;
+    for(i=0;i<PC_MAX;i++) val[i]= pc->idx[i]<0 ? 0 : buf[3+pc->idx[i]];
+    val[PC_ENABLED]=buf[1]; val[PC_RUNNING]=buf[2];
+    return 0;
+}
+
+static void perf_close(int threadId)
+{int i;
+    for(i=0;i<PC_MAX;i++) if(PerfCounter[threadId].fd[i]>=0){
+        close(PerfCounter[threadId].fd[i]); PerfCounter[threadId].fd[i]=-1;
+    }
+}
+#else /* no perf events */
+static int perf_open(int threadId){ return -1; }
+static int perf_read(int threadId, unsigned long long val[PC_MAX+2])
+{   return 1; }
+static void perf_close(int threadId){ }
+#endif /* HAVE_PERF_EVENTS */
+
+static void perf_sample(int threadId, int ph, int end)
+{perf_counter_t *pc; unsigned long long val[PC_MAX+2]; int i;
+    if(!perf_phase[ph]) return;
+    pc=&PerfCounter[threadId];
+    if(pc->state==0){
+        pc->state=perf_open(threadId);
+        if(pc->state<0 && threadId==0) report(R_warn,
+          "Hardware counters are not available (perf_event_open failed)\n");
+    }
+    if(pc->state<0) return;
+    if(!end){ perf_read(threadId,pc->start[ph]); return; }
+    if(perf_read(threadId,val)) return;
+    for(i=0;i<PC_MAX+2;i++) pc->total[ph][i] += val[i]-pc->start[ph][i];
+}
+
+int get_perf_counters(phase_t ph, double cnt[PC_MAX])
+{perf_counter_t *pc; int th,i,found; double scale;
+    found=0;
+    for(i=0;i<PC_MAX;i++) cnt[i]=-1.0;
+    for(th=0;th<MAX_THREADS;th++){
+        pc=&PerfCounter[th];
+        if(pc->state<=0 || pc->total[ph][PC_RUNNING]==0) continue;
+        found=1;
+        scale=(double)pc->total[ph][PC_ENABLED]/(double)pc->total[ph][PC_RUNNING];
+        for(i=0;i<PC_MAX;i++) if(pc->idx[i]>=0){
+            if(cnt[i]<0.0) cnt[i]=0.0;
+            cnt[i] += scale*(double)pc->total[ph][i];
+        }
+    }
+    return found;
+}
+
+/***********************************************************************
+* Telemetry records
+*
+* double telemetry_last[PH_MAX]
+*    phase totals of the main thread when the last record was written
+*
+* int telemetry_skipped
+*    iterations since the last record
+*/
+
+static double telemetry_last[PH_MAX];
+static int telemetry_skipped=0;
+
+void telemetry_iteration(int poolsize)
+{int ph,th,oraclecalls,oraclerounds; unsigned long oracletime;
+ const char *oracleversion; EDGE_FUNNEL ef; double wait;
+    if(!PARAMS(TelemetryFile)) return;
+    telemetry_skipped++;
+    if(PARAMS(TelemetrySample)>1 && telemetry_skipped<PARAMS(TelemetrySample))
+        return;
+    get_oracle_stat(&oraclecalls,&oraclerounds,&oracletime,&oracleversion);
+    report(R_telemetry,"{\"type\":\"iter\",\"iter\":%d,\"time\":%.4f,"
+        "\"sampled\":%d,\"facets\":%d,"
+        "\"pos\":%d,\"neg\":%d,\"zero\":%d,\"new\":%d,\"tests\":%.0f,"
+        "\"oracle_calls\":%d,\"oracle_iter\":%d,\"memory\":%zu,\"pool\":%d",
+        dd_stats.iterations,phase_clock(),telemetry_skipped,
+        dd_stats.facetno,dd_stats.vertex_pos,dd_stats.vertex_neg,
+        dd_stats.vertex_zero,dd_stats.vertex_new,
+        (double)dd_stats.vertex_pos*(double)dd_stats.vertex_neg,
+        oraclecalls,oraclerounds,dd_stats.total_memory,poolsize);
+    for(ph=0;ph<PH_MAX;ph++){
+        report(R_telemetry,",\"t_%s\":%.6f",phase_names[ph],
+            PhaseTimer[0].total[ph]-telemetry_last[ph]);
+        telemetry_last[ph]=PhaseTimer[0].total[ph];
+    }
+    get_edge_funnel(-1,&ef);
+    for(wait=0.0,th=0;th<MAX_THREADS;th++) wait += PhaseTimer[th].total[PH_barrier];
+    report(R_telemetry,",\"f_pairs\":%llu,\"f_few_common\":%llu,"
+        "\"f_scans\":%llu,\"f_scan_reject\":%llu,\"f_edges\":%llu,"
+        "\"f_new\":%llu,\"wait\":%.6f}\n",
+        ef.pairs,ef.few_common,ef.scans,ef.scan_reject,ef.edges,
+        ef.new_vertices,wait);
+    telemetry_skipped=0;
+}
+
+/***********************************************************************
+* Live statistics page
+*
+* livestat_t *LiveStat
+*    the mapped page, or NULL
+*
+* double wallclock(void)
+*    seconds since the epoch
+*
+* void livestat_begin(), livestat_end()
+*    open and close the sequence lock around an update
+*/
+
+static livestat_t *LiveStat=NULL;
+
+static double wallclock(void)
+{struct timeval tv;
+    if(gettimeofday(&tv,NULL)) return 0.0;
+    return (double)tv.tv_sec+1e-6*(double)tv.tv_usec;
+}
+
+static inline void livestat_begin(void)
+{   LiveStat->seq++; __sync_synchronize(); }
+
+static inline void livestat_end(void)
+{   __sync_synchronize(); LiveStat->seq++; }
+
+int livestat_open(void)
+{int fd,ph; void *page;
+    if(!PARAMS(StatFile)) return 0;
+    fd=open(PARAMS(StatFile),O_RDWR|O_CREAT|O_TRUNC,0644);
+    if(fd<0 || ftruncate(fd,sizeof(livestat_t))){
+        if(fd>=0) close(fd);
+        report(R_fatal,"Error: cannot create statistics file %s\n",PARAMS(StatFile));
+        return 1;
+    }
+    page=mmap(NULL,sizeof(livestat_t),PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+    close(fd); // the mapping is kept
+    if(page==MAP_FAILED){
+        report(R_fatal,"Error: cannot map statistics file %s\n",PARAMS(StatFile));
+        return 1;
+    }
+    LiveStat=(livestat_t *)page;
+    livestat_begin();
+    LiveStat->version=LIVESTAT_VERSION;
+    LiveStat->size=sizeof(livestat_t);
+    LiveStat->pid=(int32_t)getpid();
+    LiveStat->status=-1;
+    LiveStat->threads= PARAMS(Threads)>1 ? PARAMS(Threads) : 1;
+    LiveStat->start_time=wallclock()-phase_clock();
+    strncpy(LiveStat->name,PARAMS(ProblemName) ? PARAMS(ProblemName) : "",
+        sizeof(LiveStat->name)-1);
+    LiveStat->rows=PARAMS(ProblemRows);
+    LiveStat->cols=PARAMS(ProblemColumns);
+    LiveStat->objs=PARAMS(ProblemObjects);
+    LiveStat->phases= PH_MAX<LIVESTAT_PHASES ? PH_MAX : LIVESTAT_PHASES;
+    for(ph=0;ph<LiveStat->phases;ph++)
+        strncpy(LiveStat->phase_name[ph],phase_names[ph],LIVESTAT_NAMELEN-1);
+    livestat_end();
+    memcpy(LiveStat->magic,LIVESTAT_MAGIC,8); // valid from now on
+    livestat_update(0);
+    return 0;
+}
+
+void livestat_update(int poolsize)
+{int ph,th,oraclecalls,oraclerounds; unsigned long oracletime;
+ const char *oracleversion; double t;
+    if(!LiveStat) return;
+    get_oracle_stat(&oraclecalls,&oraclerounds,&oracletime,&oracleversion);
+    livestat_begin();
+    LiveStat->update_time=wallclock();
+    LiveStat->elapsed=phase_clock();
+    LiveStat->iterations=dd_stats.iterations;
+    LiveStat->facetno=dd_stats.facetno;
+    LiveStat->vertex_pos=dd_stats.vertex_pos;
+    LiveStat->vertex_neg=dd_stats.vertex_neg;
+    LiveStat->vertex_zero=dd_stats.vertex_zero;
+    LiveStat->vertex_new=dd_stats.vertex_new;
+    LiveStat->max_vertices=dd_stats.max_vertices;
+    LiveStat->instability_warning=dd_stats.instability_warning;
+    LiveStat->avg_tests=dd_stats.avg_tests;
+    LiveStat->max_tests=dd_stats.max_tests;
+    LiveStat->total_memory=(int64_t)dd_stats.total_memory;
+    LiveStat->max_memory=(int64_t)dd_stats.max_memory;
+    LiveStat->pool=poolsize;
+    LiveStat->oracle_calls=oraclecalls;
+    LiveStat->oracle_rounds=oraclerounds;
+    LiveStat->oracle_time=0.01*(double)oracletime;
+    for(ph=0;ph<LiveStat->phases;ph++){
+        for(t=0.0,th=0;th<MAX_THREADS;th++) t += PhaseTimer[th].total[ph];
+        LiveStat->phase_time[ph]=t;
+    }
+    livestat_end();
+}
+
+void livestat_close(int status)
+{   if(!LiveStat) return;
+    livestat_update(LiveStat->pool);
+    livestat_begin();
+    LiveStat->status=status;
+    livestat_end();
+    munmap((void *)LiveStat,sizeof(livestat_t));
+    LiveStat=NULL;
+}
+
+/***********************************************************************
+* Trace events
+*
+* int TRACE_EVENT_BLOCK, TRACE_MAX_EVENTS
+*    trace buffers are extended by that many events; a thread records
+*    at most TRACE_MAX_EVENTS events, the rest is dropped.
+*
+* trace_buffer_t TraceBuffer[MAX_THREADS]
+*    recorded events of each thread; padded to avoid false sharing
+*
+* void trace_event(threadId,ph,start,end)
+*    add an event to the buffer of the given thread
+*/
+
+#define TRACE_EVENT_BLOCK	65536
+#define TRACE_MAX_EVENTS	(64*TRACE_EVENT_BLOCK)
+
+typedef struct {
+    double start;		/* start time in seconds */
+    double end;			/* end time in seconds */
+    int    ph;			/* the phase */
+} trace_event_t;
+
+typedef struct {
+    trace_event_t *ev;		/* events */
+    int    n;			/* number of events stored */
+    int    max;			/* available space */
+    int    dropped;		/* events dropped */
+    char   pad[64];		/* avoid false sharing */
+} trace_buffer_t;
+
+static trace_buffer_t TraceBuffer[MAX_THREADS];
+
+static void trace_event(int threadId, phase_t ph, double start, double end)
+{trace_buffer_t *tb; trace_event_t *ev;
+    tb=&TraceBuffer[threadId];
+    if(tb->n>=tb->max){
+        if(tb->max>=TRACE_MAX_EVENTS){ tb->dropped++; return; }
+        ev=realloc(tb->ev,(tb->max+TRACE_EVENT_BLOCK)*sizeof(trace_event_t));
+        if(!ev){ tb->dropped++; return; }
+        tb->ev=ev; tb->max += TRACE_EVENT_BLOCK;
+    }
+    ev=tb->ev+tb->n; tb->n++;
+    ev->start=start; ev->end=end; ev->ph=ph;
+}
+
+void write_trace(void)
+{int th,i,dropped; trace_event_t *ev; char name[512];
+    if(!PARAMS(TraceFile)) return;
+    open_tracefile();
+    report(R_trace,"{\"traceEvents\":[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+        "\"args\":{\"name\":\"%s\"}}",
+        json_escape(name,sizeof(name),PARAMS(ProblemName)));
+    dropped=0;
+    for(th=0;th<MAX_THREADS;th++) if(TraceBuffer[th].n>0){
+        report(R_trace,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+            "\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+            th,th==0 ? "main" : "thread",th);
+        for(i=0,ev=TraceBuffer[th].ev;i<TraceBuffer[th].n;i++,ev++){
+            report(R_trace,",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+                "\"tid\":%d,\"ts\":%.1f,\"dur\":%.1f}",
+                phase_names[ev->ph],th,1e6*ev->start,1e6*(ev->end-ev->start));
+        }
+        dropped += TraceBuffer[th].dropped;
+    }
+    report(R_trace,"\n],\"displayTimeUnit\":\"ms\","
+        "\"otherData\":{\"dropped_events\":%d}}\n",dropped);
+    close_tracefile();
+}
+
+/***********************************************************************
+* Starting again
+*/
+
+void telemetry_reset(void)
+{int th;
+    for(th=0;th<MAX_THREADS;th++){
+        free(TraceBuffer[th].ev);
+        if(PerfCounter[th].state>0) perf_close(th);
+    }
+    memset(PhaseTimer,0,sizeof(PhaseTimer));
+    memset(PerfCounter,0,sizeof(PerfCounter));
+    memset(TraceBuffer,0,sizeof(TraceBuffer));
+    memset(telemetry_last,0,sizeof(telemetry_last));
+    telemetry_skipped=0;
+}
+
+/* EOF */
+
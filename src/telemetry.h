@@ -0,0 +1,160 @@
+/** telemetry.h  --  phase timers and machine readable run data **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Phase timers
+*
+* phase_t
+*    the main phases of the algorithm which are timed separately.
+*
+* double phase_clock(void)
+*    monotonic wall clock in seconds, counted from (about) the first
+*    call of this routine.
+*
+* void phase_begin(int threadId, phase_t ph)
+* void phase_end(int threadId, phase_t ph)
+*    start and stop the stopwatch of phase 'ph' for the given thread.
+*    Without threads threadId is zero. The elapsed time is added to
+*    the total of that phase. When PARAMS(TraceFile) is set, the phase
+*    is also recorded as a trace event in the buffer of the thread.
+*
+* double phase_total(int threadId, phase_t ph)
+*    total time spent in phase 'ph' by the given thread, in seconds.
+*
+* const char *phase_name(phase_t ph)
+*    short name of the phase used in reports.
+*/
+
+typedef enum {
+PH_oracle,	/* ask_oracle() calls */
+PH_probe,	/* scoring facets in the facet pool */
+PH_classify,	/* computing vertex distances from the new facet */
+PH_search,	/* searching edges crossing the new facet */
+PH_update,	/* storing new vertices, compressing */
+PH_recalc,	/* recalculating vertex coordinates */
+PH_checkpoint,	/* writing checkpoint and dump files */
+PH_edges,	/* edge tests done by a single thread */
+PH_barrier,	/* waiting for other threads to finish */
+PH_MAX		/* number of phases */
+} phase_t;
+
+double phase_clock(void);
+void phase_begin(int threadId, phase_t ph);
+void phase_end(int threadId, phase_t ph);
+double phase_total(int threadId, phase_t ph);
+const char *phase_name(phase_t ph);
+
+/***********************************************************************
+* Hardware counters
+*
+* perfcnt_t
+*    hardware events counted by perf_event_open() in the hot phases
+*    oracle, probe, classify, search and edges when PARAMS(PerfCounters)
+*    is set. Available on Linux only.
+*
+* int get_perf_counters(phase_t ph, double cnt[PC_MAX])
+*    total of the counters in phase 'ph' summed over all threads. When
+*    the kernel multiplexed the counters, values are scaled up. A
+*    counter which could not be opened is set to -1. Return value is
+*    zero if no counters are available at all.
+*/
+
+typedef enum {
+PC_cycles,	/* CPU cycles */
+PC_instructions,/* instructions retired */
+PC_llc_misses,	/* last level cache read misses */
+PC_dtlb_misses,	/* data TLB read misses */
+PC_branch_misses,/* mispredicted branches */
+PC_MAX		/* number of counters */
+} perfcnt_t;
+
+int get_perf_counters(phase_t ph, double cnt[PC_MAX]);
+
+/***********************************************************************
+* Telemetry stream
+*
+* void telemetry_iteration(int poolsize)
+*    when PARAMS(TelemetryFile) is set, write a single line JSON record
+*    after every PARAMS(TelemetrySample) iterations to the R_telemetry
+*    channel. The record contains the last vertex statistics, oracle
+*    counters, memory usage, the facet pool size, and the time spent
+*    in each phase since the previous record.
+*/
+
+void telemetry_iteration(int poolsize);
+
+/***********************************************************************
+* Memory events
+*
+* void telemetry_memory(int slot, const char *title, const char *kind,
+*      size_t oldsize, size_t newsize, size_t blocks, size_t blocksize,
+*      size_t moved, double elapsed)
+*    when PARAMS(TelemetryFile) is set, write a record of type "mem"
+*    telling that memory of the slot changed from oldsize to newsize
+*    bytes, it has now that many blocks of the given size, 'moved'
+*    bytes were moved when blocks were restrided, and the change took
+*    'elapsed' seconds. 'kind' is "main" or "temp". Can be called from
+*    any thread once open_telemetryfile() has been called.
+*/
+
+void telemetry_memory(int slot, const char *title, const char *kind,
+    size_t oldsize, size_t newsize, size_t blocks, size_t blocksize,
+    size_t moved, double elapsed);
+
+/***********************************************************************
+* Live statistics page
+*
+* int livestat_open(void)
+*    when PARAMS(StatFile) is set, create that file, map it into the
+*    memory, and fill the static part of the statistics page defined
+*    in livestat.h. Return non-zero if the file cannot be created.
+*
+* void livestat_update(int poolsize)
+*    copy the actual statistics to the page
+*
+* void livestat_close(int status)
+*    update the page for the last time with the given exit status
+*    and unmap it. The file is kept.
+*/
+
+int livestat_open(void);
+void livestat_update(int poolsize);
+void livestat_close(int status);
+
+/***********************************************************************
+* Trace events
+*
+* void write_trace(void)
+*    when PARAMS(TraceFile) is set, write all recorded phases as
+*    "complete" events in the Chrome / Perfetto trace-event JSON
+*    format. Events are kept, thus calling this routine again rewrites
+*    the file with the events recorded so far. Should be called only
+*    when extra threads are not working.
+*/
+
+void write_trace(void);
+
+/***********************************************************************
+* Starting again
+*
+* void telemetry_reset(void)
+*    clear the phase timers and the telemetry record state, close the
+*    hardware counters and release the trace events, so that the next
+*    problem solved in the process starts from zero. Should be called
+*    only when extra threads are not working.
+*/
+
+void telemetry_reset(void);
+
+/* EOF */
+
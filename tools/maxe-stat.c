@@ -0,0 +1,214 @@
+/** maxe-stat.c  --  display live statistics of running maxe jobs **/
+
+/***********************************************************************
+ * This code is part of MAXE, a helper program for maximum entropy method.
+ *
+ * Copyright (C) 2025 Laszlo Csirmaz, https://github.com/lcsirmaz/MAXE
+ *
+ * This program is free, open-source software. You may redistribute it
+ * and/or modify under the terms of the GNU General Public License (GPL).
+ *
+ * There is ABSOLUTELY NO WARRANTY, use at your own risk.
+ ***********************************************************************/
+
+/***********************************************************************
+* Usage:
+*    maxe-stat [-w T] <file> [<file> ...]
+*
+* <file> is the statistics file given to maxe after the option -os.
+* With a single file all statistics are printed; with several files
+* one line is printed for each job. With -w T the display is repeated
+* in every T seconds until interrupted.
+*
+* Compile from the MAXE/tools directory as
+*    gcc -O2 -W -I../src -o maxe-stat maxe-stat.c
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>	/* kill() */
+#include <sys/time.h>	/* gettimeofday() */
+#include <unistd.h>	/* sleep(), close() */
+#include <fcntl.h>	/* open() */
+#include <sys/mman.h>	/* mmap() */
+#include <sys/stat.h>	/* fstat() */
+#include "livestat.h"
+
+/***********************************************************************
+* int read_stat(const char *fname, livestat_t *st)
+*    map the file, check the header, and make a consistent copy of the
+*    page using the sequence lock. A file shorter than the page is not
+*    mapped, as reading past its end raises SIGBUS. Return value:
+*      0: OK, 1: cannot open, 2: not a statistics file, 3: busy
+*
+* const char *job_state(livestat_t *st)
+*    running, finished, or dead when the writer is no more
+*
+* char *readable(double w, int slot)
+*    convert w to a string with k,M,G,T postfix using one of the
+*    static strings at slots 0,1,2,3
+*
+* char *showtime(double t)
+*    time in days, hours, minutes and seconds
+*
+* double wallclock(void)
+*    seconds since the epoch
+*/
+
+static double wallclock(void)
+{struct timeval tv;
+    if(gettimeofday(&tv,NULL)) return 0.0;
+    return (double)tv.tv_sec+1e-6*(double)tv.tv_usec;
+}
+
+static int read_stat(const char *fname, livestat_t *st)
+{int fd,i; livestat_t *page; uint32_t seq; int ret; struct stat sb;
+    fd=open(fname,O_RDONLY);
+    if(fd<0) return 1;
+    if(fstat(fd,&sb) || sb.st_size<(off_t)sizeof(livestat_t)){
+        close(fd); return 2;
+    }
+    page=(livestat_t *)mmap(NULL,sizeof(livestat_t),PROT_READ,MAP_SHARED,fd,0);
+    close(fd);
+    if((void *)page==MAP_FAILED) return 2;
+    if(memcmp(page->magic,LIVESTAT_MAGIC,8)!=0 || page->version!=LIVESTAT_VERSION
+       || page->size!=sizeof(livestat_t)){
+        munmap((void *)page,sizeof(livestat_t)); return 2;
+    }
+    ret=3;
+    for(i=0;i<1000;i++){
+        seq=page->seq;
+        if(seq&1){ usleep(100); continue; }
+        __sync_synchronize();
+        memcpy(st,page,sizeof(livestat_t));
+        __sync_synchronize();
+        if(page->seq==seq){ ret=0; break; }
+    }
+    munmap((void *)page,sizeof(livestat_t));
+    return ret;
+}
+
+static const char *job_state(livestat_t *st)
+{   if(st->status>=0) return st->status==0 ? "done" : "stopped";
+    if(kill((pid_t)st->pid,0)!=0) return "dead";
+    return "running";
+}
+
+static char* readable(double w, int slot)
+{static char slots[4][30]; char *buff;
+    buff=slots[slot];
+    if(w<0.0){ w=0.0; } /* only >=0 numbers */
+    if(w<1000.0){ sprintf(buff,"%.0lf",w); return buff;}
+    w*=0.001;
+    if(w<1000.0){ sprintf(buff,"%.2lfk",w); return buff; }
+    w*=0.001;
+    if(w<1000.0){ sprintf(buff,"%.2lfM",w); return buff; }
+    w*=0.001;
+    if(w<1000.0){ sprintf(buff,"%.2lfG",w); return buff; }
+    w*=0.001;
+    sprintf(buff,"%.2lfT",w); return buff;
+}
+
+static char *showtime(double t)
+{static char buff[50]; int m,s;
+    if(t<60.0){ sprintf(buff,"%.2f",t); return buff;}
+    s=(int)(t+0.5); m=s/60; s=s%60;
+    if(m<60){ sprintf(buff,"%d:%02d",m,s); return buff; }
+    if(m<60*24){ sprintf(buff,"%d:%02d:%02d",m/60,m%60,s); return buff;}
+    sprintf(buff,"%dd%02d:%02d:%02d",m/1440,(m/60)%24,m%60,s); return buff;
+}
+
+/***********************************************************************
+* Printing
+*
+* void print_long(const char *fname, livestat_t *st)
+*    print all data of a single job
+*
+* void print_header(void), print_short(const char *fname, livestat_t *st)
+*    print a single line for each job
+*/
+
+static void print_long(const char *fname, livestat_t *st)
+{int ph;
+    printf("%s: problem %s, pid %d, %s\n",fname,st->name,st->pid,job_state(st));
+    printf(" rows, cols, objs        %d, %d, %d\n",st->rows,st->cols,st->objs);
+    printf(" elapsed time            %s\n",showtime(st->elapsed));
+    printf(" last update             %s ago\n",showtime(st->update_time>0.0 ?
+         wallclock()-st->update_time : 0.0));
+    printf(" threads                 %d\n",st->threads);
+    printf(" iterations              %d\n",st->iterations);
+    printf(" facets                  %d\n",st->facetno);
+    printf(" last +/-/0 vertices     %d / %d / %d\n",
+        st->vertex_pos,st->vertex_neg,st->vertex_zero);
+    printf(" vertices added          %s\n",readable((double)st->vertex_new,0));
+    printf(" max vertices            %s\n",readable((double)st->max_vertices,0));
+    printf(" edge tests avg / max    %s / %s\n",
+        readable(st->avg_tests,0),readable(st->max_tests,1));
+    printf(" memory now / max        %s / %s\n",
+        readable((double)st->total_memory,0),readable((double)st->max_memory,1));
+    printf(" facet pool              %d\n",st->pool);
+    printf(" LP calls / iterations   %s / %s\n",
+        readable((double)st->oracle_calls,0),readable((double)st->oracle_rounds,1));
+    printf(" LP time                 %s\n",showtime(st->oracle_time));
+    if(st->instability_warning)
+        printf(" instability warnings    %d\n",st->instability_warning);
+    printf(" phase times\n");
+    for(ph=0;ph<st->phases && ph<LIVESTAT_PHASES;ph++){
+        st->phase_name[ph][LIVESTAT_NAMELEN-1]=0;
+        printf("   %-21s %s\n",st->phase_name[ph],showtime(st->phase_time[ph]));
+    }
+}
+
+static void print_header(void)
+{   printf("%-20s %-8s %-16s %10s %8s %8s %8s %8s %9s\n",
+      "file","state","problem","time","iter","facets","pos","neg","memory");
+}
+
+static void print_short(const char *fname, livestat_t *st)
+{   st->name[sizeof(st->name)-1]=0;
+    printf("%-20s %-8s %-16.16s %10s %8d %8d %8d %8d %9s\n",fname,job_state(st),
+      st->name,showtime(st->elapsed),st->iterations,st->facetno,st->vertex_pos,
+      st->vertex_neg,readable((double)st->total_memory,0));
+}
+
+/***********************************************************************
+* Main program
+*/
+
+static void usage(void)
+{   printf("usage: maxe-stat [-w T] <file> [<file> ...]\n"
+      "display statistics published by maxe -os <file>; repeat in every\n"
+      "T seconds when -w T is given.\n");
+}
+
+int main(int argc, char *argv[])
+{int i,first,wait,err; livestat_t st;
+    wait=0; first=1;
+    if(first<argc && strcmp(argv[first],"-w")==0){
+        if(first+1>=argc || (wait=atoi(argv[first+1]))<=0){ usage(); return 1; }
+        first+=2;
+    }
+    if(first>=argc || argv[first][0]=='-'){ usage(); return 1; }
+    err=0;
+    for(;;){
+        if(argc-first>1) print_header();
+        for(i=first;i<argc;i++){
+            switch(read_stat(argv[i],&st)){
+              case 0: if(argc-first>1) print_short(argv[i],&st);
+                      else print_long(argv[i],&st);
+                      break;
+              case 1: printf("%-20s cannot open\n",argv[i]); err=1; break;
+              case 2: printf("%-20s not a maxe statistics file\n",argv[i]); err=1; break;
+              default:printf("%-20s busy, try again\n",argv[i]); break;
+            }
+        }
+        if(!wait) break;
+        fflush(stdout); sleep((unsigned)wait);
+        printf("\n");
+    }
+    return err;
+}
+
+/* EOF */
+